@@ -83,6 +83,8 @@ template <typename R> struct ArchAPI : BaseCtx
     virtual WireId getConflictingWireWire(WireId wire) const = 0;
     virtual NetInfo *getConflictingWireNet(WireId wire) const = 0;
     virtual DelayQuad getWireDelay(WireId wire) const = 0;
+    virtual int getFlatWireCount() const = 0;
+    virtual int getFlatWireIndex(WireId wire) const = 0;
     // Pip methods
     virtual typename R::AllPipsRangeT getPips() const = 0;
     virtual PipId getPipByName(IdStringList name) const = 0;
@@ -149,6 +151,10 @@ template <typename R> struct ArchAPI : BaseCtx
     // Flow methods
     virtual bool pack() = 0;
     virtual bool place() = 0;
+    // Used instead of place() when the placement is loaded from a checkpoint, to set up and finalise the
+    // arch-specific state that place() would otherwise have handled around the placer itself
+    virtual void preLoadPlacement() = 0;
+    virtual void postLoadPlacement() = 0;
     virtual bool route() = 0;
     virtual void assignArchInfo() = 0;
 };
@@ -237,6 +237,8 @@ template <typename R> struct BaseArch : ArchAPI<R>
     }
     virtual WireId getConflictingWireWire(WireId wire) const override { return wire; };
     virtual NetInfo *getConflictingWireNet(WireId wire) const override { return getBoundWireNet(wire); }
+    virtual int getFlatWireCount() const override { return 0; }
+    virtual int getFlatWireIndex(WireId wire) const override { return -1; }
 
     // Pip methods
     virtual IdString getPipType(PipId pip) const override { return IdString(); }
@@ -438,6 +440,8 @@ template <typename R> struct BaseArch : ArchAPI<R>
 
     // Flow methods
     virtual void assignArchInfo() override{};
+    virtual void preLoadPlacement() override{};
+    virtual void postLoadPlacement() override { this->archInfoToAttributes(); };
 
     // --------------------------------------------------------------
     // These structures are used to provide default implementations of bel/wire/pip binding. Arches might want to
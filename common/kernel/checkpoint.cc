@@ -0,0 +1,414 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+#include "log.h"
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+/*
+Binary placement and routing checkpoint. Only the physical implementation is stored, the netlist itself comes from
+the usual frontend, so cells and nets are matched up by name when loading. That means a checkpoint can also be applied
+to a slightly modified netlist: anything that no longer matches is simply left for the placer and router.
+
+All integers are unsigned LEB128 varints.
+
+    magic ("NPCK"), version, chip name
+    string table: count, then (length, bytes) for each string
+    cells: count, then for each placed cell
+        name, type (string indices), bel name (count, string indices), strength
+    nets: count, then for each routed net
+        name (string index), number of root wires, number of pips
+        roots: wire name (count, string indices), strength
+        pips: parent, downhill index, strength
+
+Routing is stored as a tree rather than by pip name, which is both smaller and much faster to load than looking up
+names. Wires are numbered in order: roots first, then the destination wire of each pip. A pip is stored as the number
+of the wire it is driven from and its index in getPipsDownhill of that wire.
+*/
+
+namespace {
+
+const uint32_t checkpoint_magic = 0x4b43504e; // "NPCK"
+const uint32_t checkpoint_version = 1;
+
+struct CheckpointWriter
+{
+    Context *ctx;
+    std::string body;
+    dict<IdString, int> string_idx;
+    std::vector<IdString> strings;
+
+    explicit CheckpointWriter(Context *ctx) : ctx(ctx){};
+
+    static void write_uint(std::string &out, uint64_t value)
+    {
+        do {
+            uint8_t byte = value & 0x7F;
+            value >>= 7;
+            if (value != 0)
+                byte |= 0x80;
+            out.push_back(char(byte));
+        } while (value != 0);
+    }
+
+    void write_uint(uint64_t value) { write_uint(body, value); }
+
+    void write_id(IdString id)
+    {
+        auto found = string_idx.find(id);
+        if (found == string_idx.end()) {
+            found = string_idx.emplace(id, int(strings.size())).first;
+            strings.push_back(id);
+        }
+        write_uint(found->second);
+    }
+
+    void write_id_list(const IdStringList &list)
+    {
+        write_uint(list.size());
+        for (auto id : list)
+            write_id(id);
+    }
+
+    void write_cells()
+    {
+        std::vector<CellInfo *> placed;
+        for (auto &cell : ctx->cells)
+            if (cell.second->bel != BelId())
+                placed.push_back(cell.second.get());
+        write_uint(placed.size());
+        for (auto ci : placed) {
+            write_id(ci->name);
+            write_id(ci->type);
+            write_id_list(ctx->getBelName(ci->bel));
+            write_uint(ci->belStrength);
+        }
+    }
+
+    void write_net(NetInfo *ni)
+    {
+        std::vector<WireId> roots;
+        dict<WireId, std::vector<PipId>> downhill;
+        for (auto &wire : ni->wires) {
+            if (wire.second.pip == PipId())
+                roots.push_back(wire.first);
+            else
+                downhill[ctx->getPipSrcWire(wire.second.pip)].push_back(wire.second.pip);
+        }
+
+        // Number wires breadth-first from the roots
+        std::vector<WireId> order(roots);
+        std::string pips;
+        int num_pips = 0;
+        for (size_t i = 0; i < order.size(); i++) {
+            auto found = downhill.find(order.at(i));
+            if (found == downhill.end())
+                continue;
+            for (PipId pip : found->second) {
+                int pip_index = 0;
+                for (PipId dh : ctx->getPipsDownhill(order.at(i))) {
+                    if (dh == pip)
+                        break;
+                    ++pip_index;
+                }
+                WireId dst = ctx->getPipDstWire(pip);
+                write_uint(pips, i);
+                write_uint(pips, pip_index);
+                write_uint(pips, ni->wires.at(dst).strength);
+                order.push_back(dst);
+                ++num_pips;
+            }
+        }
+        if (order.size() != ni->wires.size())
+            log_warning("Routing of net '%s' is not a tree, %d wire(s) will be missing from the checkpoint.\n",
+                        ctx->nameOf(ni), int(ni->wires.size() - order.size()));
+
+        write_id(ni->name);
+        write_uint(roots.size());
+        write_uint(num_pips);
+        for (WireId root : roots) {
+            write_id_list(ctx->getWireName(root));
+            write_uint(ni->wires.at(root).strength);
+        }
+        body += pips;
+    }
+
+    void write_nets()
+    {
+        std::vector<NetInfo *> routed;
+        for (auto &net : ctx->nets)
+            if (!net.second->wires.empty())
+                routed.push_back(net.second.get());
+        write_uint(routed.size());
+        for (auto ni : routed)
+            write_net(ni);
+    }
+
+    void write(std::ostream &out)
+    {
+        write_cells();
+        write_nets();
+
+        std::string header;
+        write_uint(header, checkpoint_magic);
+        write_uint(header, checkpoint_version);
+        std::string chip = ctx->getChipName();
+        write_uint(header, chip.size());
+        header += chip;
+        write_uint(header, strings.size());
+        for (auto id : strings) {
+            const std::string &s = id.str(ctx);
+            write_uint(header, s.size());
+            header += s;
+        }
+        out.write(header.data(), header.size());
+        out.write(body.data(), body.size());
+    }
+};
+
+struct CheckpointReader
+{
+    Context *ctx;
+    std::string filename;
+    std::vector<char> data;
+    size_t pos = 0;
+    std::vector<IdString> strings;
+
+    // Placement and routing are restored separately, as the arch may still change the placement (and so the pins that
+    // routing must reach) before routing is restored
+    bool load_placement, load_routing;
+
+    CheckpointReader(Context *ctx, const std::string &filename, bool load_placement, bool load_routing)
+            : ctx(ctx), filename(filename), load_placement(load_placement), load_routing(load_routing){};
+
+    uint64_t read_uint()
+    {
+        uint64_t value = 0;
+        int shift = 0;
+        while (true) {
+            if (pos >= data.size() || shift > 63)
+                log_error("Checkpoint '%s' is truncated or corrupt.\n", filename.c_str());
+            uint8_t byte = uint8_t(data.at(pos++));
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                break;
+            shift += 7;
+        }
+        return value;
+    }
+
+    std::string read_str()
+    {
+        size_t len = read_uint();
+        if (pos + len > data.size())
+            log_error("Checkpoint '%s' is truncated or corrupt.\n", filename.c_str());
+        std::string s(data.data() + pos, len);
+        pos += len;
+        return s;
+    }
+
+    IdString read_id()
+    {
+        uint64_t idx = read_uint();
+        if (idx >= strings.size())
+            log_error("Checkpoint '%s' is corrupt (bad string index).\n", filename.c_str());
+        return strings.at(idx);
+    }
+
+    IdStringList read_id_list()
+    {
+        IdStringList list(read_uint());
+        for (size_t i = 0; i < list.size(); i++)
+            list.ids[i] = read_id();
+        return list;
+    }
+
+    void read_header()
+    {
+        if (read_uint() != checkpoint_magic)
+            log_error("'%s' is not a nextpnr checkpoint.\n", filename.c_str());
+        uint64_t version = read_uint();
+        if (version != checkpoint_version)
+            log_error("Checkpoint '%s' has unsupported version %d (expected %d).\n", filename.c_str(), int(version),
+                      int(checkpoint_version));
+        std::string chip = read_str();
+        if (chip != ctx->getChipName())
+            log_error("Checkpoint '%s' is for chip '%s', but the current chip is '%s'.\n", filename.c_str(),
+                      chip.c_str(), ctx->getChipName().c_str());
+        size_t num_strings = read_uint();
+        strings.reserve(num_strings);
+        for (size_t i = 0; i < num_strings; i++)
+            strings.push_back(ctx->id(read_str()));
+    }
+
+    void read_cells()
+    {
+        size_t num_cells = read_uint();
+        int placed = 0, skipped = 0;
+        std::vector<CellInfo *> bound;
+        for (size_t i = 0; i < num_cells; i++) {
+            IdString name = read_id(), type = read_id();
+            IdStringList bel_name = read_id_list();
+            auto strength = PlaceStrength(read_uint());
+            if (!load_placement)
+                continue;
+            auto found = ctx->cells.find(name);
+            if (found == ctx->cells.end() || found->second->type != type) {
+                ++skipped;
+                continue;
+            }
+            CellInfo *ci = found->second.get();
+            BelId bel = ctx->getBelByName(bel_name);
+            if (ci->bel != BelId()) {
+                // Already placed, e.g. by a constraint
+                if (ci->bel != bel)
+                    ++skipped;
+                continue;
+            }
+            if (bel == BelId() || !ctx->checkBelAvail(bel) || !ctx->isValidBelForCellType(ci->type, bel)) {
+                ++skipped;
+                continue;
+            }
+            ctx->bindBel(bel, ci, strength);
+            bound.push_back(ci);
+        }
+        // Cells whose neighbours changed in the netlist might no longer form a legal placement
+        for (auto ci : bound) {
+            if (ctx->isBelLocationValid(ci->bel)) {
+                ++placed;
+            } else {
+                ctx->unbindBel(ci->bel);
+                ++skipped;
+            }
+        }
+        if (load_placement)
+            log_info("    placed %d cells from checkpoint (%d skipped)\n", placed, skipped);
+    }
+
+    void read_nets()
+    {
+        size_t num_nets = read_uint();
+        int routed = 0, skipped = 0;
+        std::vector<WireId> wires;
+        for (size_t i = 0; i < num_nets; i++) {
+            IdString name = read_id();
+            size_t num_roots = read_uint(), num_pips = read_uint();
+            auto found = ctx->nets.find(name);
+            NetInfo *ni = (found != ctx->nets.end()) ? found->second.get() : nullptr;
+            // Still need to consume the whole record if the net is skipped
+            bool ok = (load_routing && ni != nullptr && ni->wires.empty());
+            wires.clear();
+            for (size_t j = 0; j < num_roots; j++) {
+                IdStringList wire_name = read_id_list();
+                auto strength = PlaceStrength(read_uint());
+                if (!ok)
+                    continue;
+                WireId wire = ctx->getWireByName(wire_name);
+                if (wire == WireId() || !ctx->checkWireAvail(wire)) {
+                    ok = false;
+                    continue;
+                }
+                ctx->bindWire(wire, ni, strength);
+                wires.push_back(wire);
+            }
+            for (size_t j = 0; j < num_pips; j++) {
+                size_t parent = read_uint(), pip_index = read_uint();
+                auto strength = PlaceStrength(read_uint());
+                if (!ok)
+                    continue;
+                if (parent >= wires.size()) {
+                    ok = false;
+                    continue;
+                }
+                PipId pip;
+                for (PipId dh : ctx->getPipsDownhill(wires.at(parent))) {
+                    if (pip_index-- == 0) {
+                        pip = dh;
+                        break;
+                    }
+                }
+                if (pip == PipId() || !ctx->checkPipAvailForNet(pip, ni) ||
+                    !ctx->checkWireAvail(ctx->getPipDstWire(pip))) {
+                    ok = false;
+                    continue;
+                }
+                ctx->bindPip(pip, ni, strength);
+                wires.push_back(ctx->getPipDstWire(pip));
+            }
+            if (ok && ni->driver.cell != nullptr) {
+                // The driver may have moved, or the arch remapped its pin, since the checkpoint was written
+                WireId src = ctx->getNetinfoSourceWire(ni);
+                ok = (src != WireId() && ctx->getBoundWireNet(src) == ni);
+            }
+            if (ok) {
+                ++routed;
+            } else if (load_routing) {
+                // Leave the net for the router rather than keep partial routing that might be nonsense
+                if (ni != nullptr && !wires.empty())
+                    ctx->ripupNet(ni->name);
+                ++skipped;
+            }
+        }
+        if (load_routing) {
+            log_info("    routed %d nets from checkpoint (%d skipped)\n", routed, skipped);
+            // Tells the router that existing routing may have branches to sinks that have since moved
+            if (routed > 0)
+                ctx->settings[ctx->id("router/restoredRouting")] = true;
+        }
+    }
+
+    void read()
+    {
+        std::ifstream in(filename, std::ios::binary);
+        if (!in)
+            log_error("Failed to open checkpoint '%s' for reading.\n", filename.c_str());
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        read_header();
+        read_cells();
+        read_nets();
+        if (pos != data.size())
+            log_error("Checkpoint '%s' has trailing data.\n", filename.c_str());
+    }
+};
+
+} // namespace
+
+void Context::writeCheckpoint(std::ostream &out)
+{
+    CheckpointWriter writer(this);
+    writer.write(out);
+}
+
+void Context::readCheckpoint(const std::string &filename, bool placement, bool routing)
+{
+    log_info("Loading %s from checkpoint '%s'...\n",
+             placement ? (routing ? "placement and routing" : "placement") : "routing", filename.c_str());
+    auto start = std::chrono::high_resolution_clock::now();
+    CheckpointReader reader(this, filename, placement, routing);
+    reader.read();
+    auto end = std::chrono::high_resolution_clock::now();
+    log_info("    checkpoint loaded in %.02fs\n", std::chrono::duration<float>(end - start).count());
+}
+
+NEXTPNR_NAMESPACE_END
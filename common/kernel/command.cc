@@ -27,6 +27,7 @@
 #include "pybindings.h"
 #endif
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/join.hpp>
 #include <boost/filesystem/convenience.hpp>
@@ -41,6 +42,7 @@
 #include "json_frontend.h"
 #include "jsonwrite.h"
 #include "log.h"
+#include "route_queue.h"
 #include "timing.h"
 #include "util.h"
 #include "version.h"
@@ -116,6 +118,11 @@ bool CommandHandler::executeBeforeContext()
             log_error("Failed to open log file '%s' for writing.\n", logfilename.c_str());
         log_streams.push_back(std::make_pair(&logfile, LogLevel::LOG_MSG));
     }
+
+    if (vm.count("bench-idstring")) {
+        idstring_benchmark(vm["bench-idstring"].as<int>());
+        return true;
+    }
     return false;
 }
 
@@ -152,6 +159,10 @@ po::options_description CommandHandler::getGeneralOptions()
 #endif
     general.add_options()("json", po::value<std::string>(), "JSON design file to ingest");
     general.add_options()("write", po::value<std::string>(), "JSON design file to write");
+    general.add_options()("load-checkpoint", po::value<std::string>(),
+                          "binary placement/routing checkpoint to apply after packing");
+    general.add_options()("write-checkpoint", po::value<std::string>(),
+                          "binary placement/routing checkpoint to write at the end of the flow");
     general.add_options()("top", po::value<std::string>(), "name of top module");
     general.add_options()("seed", po::value<int>(), "seed value for random number generator");
     general.add_options()("randomize-seed,r", "randomize seed value for random number generator");
@@ -183,6 +194,8 @@ po::options_description CommandHandler::getGeneralOptions()
 
     general.add_options()("version,V", "show version");
     general.add_options()("test", "check architecture database integrity");
+    general.add_options()("bench-idstring", po::value<int>(),
+                          "measure IdString interning throughput for up to the given number of threads");
     general.add_options()("freq", po::value<double>(), "set target frequency for design in MHz");
     general.add_options()("timing-allow-fail", "allow timing to fail in design");
     general.add_options()("no-tmdriv", "disable timing-driven placement");
@@ -200,12 +213,27 @@ po::options_description CommandHandler::getGeneralOptions()
                           "allow placer to attempt up to max(10000, total cells^2 / N) iterations to place a cell (int "
                           "N, default: 8, 0 for no timeout)");
 
+    general.add_options()("placer-heap-solver-ic",
+                          "use an incomplete Cholesky rather than Jacobi preconditioner for the placer heap solver");
+
 #if !defined(NPNR_DISABLE_THREADS)
     general.add_options()("parallel-refine", "use new experimental parallelised engine for placement refinement");
+    general.add_options()("no-parallel-refine", "disable the parallelised placement refinement engine");
 #endif
 
+    general.add_options()("router-queue-arity", po::value<int>(),
+                          "arity of the router A* queue heaps, 2 for a binary heap that breaks ties like "
+                          "std::priority_queue (int, default: 2)");
+    general.add_options()("bench-router-queue", "time the router A* queue against std::priority_queue and exit");
     general.add_options()("router2-heatmap", po::value<std::string>(),
                           "prefix for router2 resource congestion heatmaps");
+    general.add_options()("router2-incremental",
+                          "keep existing routing of nets that are still legally routed, and only route the rest "
+                          "(saves routing time; per-wire memory is still allocated for the whole device)");
+    general.add_options()("router2-perf-profile",
+                          "log router2 search statistics: wires explored, wall time and cache misses per arc");
+    general.add_options()("router2-trace", po::value<std::string>(),
+                          "write router2 per-iteration statistics to a JSON file");
 
     general.add_options()("tmg-ripup", "enable experimental timing-driven ripup in router");
     general.add_options()("router2-tmg-ripup",
@@ -344,11 +372,28 @@ void CommandHandler::setupContext(Context *ctx)
         ctx->settings[ctx->id("placerHeap/cellPlacementTimeout")] =
                 std::to_string(std::max(0, vm["placer-heap-cell-placement-timeout"].as<int>()));
 
+    if (vm.count("placer-heap-solver-ic"))
+        ctx->settings[ctx->id("placerHeap/solverIC")] = true;
+
     if (vm.count("parallel-refine"))
         ctx->settings[ctx->id("placerHeap/parallelRefine")] = true;
+    if (vm.count("no-parallel-refine"))
+        ctx->settings[ctx->id("placerHeap/parallelRefine")] = false;
+
+    if (vm.count("router-queue-arity"))
+        ctx->settings[ctx->id("router/queueArity")] = std::to_string(vm["router-queue-arity"].as<int>());
 
     if (vm.count("router2-heatmap"))
         ctx->settings[ctx->id("router2/heatmap")] = vm["router2-heatmap"].as<std::string>();
+
+    if (vm.count("router2-incremental"))
+        ctx->settings[ctx->id("router2/incremental")] = true;
+
+    if (vm.count("router2-perf-profile"))
+        ctx->settings[ctx->id("router2/perfProfile")] = true;
+
+    if (vm.count("router2-trace"))
+        ctx->settings[ctx->id("router2/trace")] = vm["router2-trace"].as<std::string>();
     if (vm.count("tmg-ripup") || vm.count("router2-tmg-ripup"))
         ctx->settings[ctx->id("router/tmg_ripup")] = true;
 
@@ -395,6 +440,11 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         return 0;
     }
 
+    if (vm.count("bench-router-queue")) {
+        route_queue_benchmark();
+        return 0;
+    }
+
     if (vm.count("top")) {
         ctx->settings[ctx->id("frontend/top")] = vm["top"].as<std::string>();
     }
@@ -407,7 +457,7 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
             if (vm.count("json")) {
                 std::string filename = vm["json"].as<std::string>();
                 std::ifstream f(filename);
-                if (!parse_json(f, filename, w.getContext()))
+                if (!parse_json(f, filename, w.getContext(), /*map_file=*/true))
                     log_error("Loading design failed.\n");
                 customAfterLoad(w.getContext());
                 w.notifyChangeContext();
@@ -425,7 +475,7 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
     if (vm.count("json")) {
         std::string filename = vm["json"].as<std::string>();
         std::ifstream f(filename);
-        if (!parse_json(f, filename, ctx.get()))
+        if (!parse_json(f, filename, ctx.get(), /*map_file=*/true))
             log_error("Loading design failed.\n");
 
         customAfterLoad(ctx.get());
@@ -456,6 +506,22 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         ctx->check();
         print_utilisation(ctx.get());
 
+        if (vm.count("load-checkpoint")) {
+            ctx->preLoadPlacement();
+            ctx->readCheckpoint(vm["load-checkpoint"].as<std::string>(), /*placement=*/true, /*routing=*/false);
+            ctx->check();
+            if (do_place && std::all_of(ctx->cells.begin(), ctx->cells.end(),
+                                        [](const std::pair<IdString, std::unique_ptr<CellInfo>> &cell) {
+                                            return cell.second->bel != BelId();
+                                        })) {
+                log_info("All cells placed from checkpoint, skipping placement.\n");
+                do_place = false;
+            }
+            // place() finalises the arch state itself; otherwise the loaded placement must be finalised here
+            if (!do_place)
+                ctx->postLoadPlacement();
+        }
+
         if (do_place) {
             run_script_hook("pre-place");
             bool saved_debug = ctx->debug;
@@ -469,6 +535,13 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
                 ctx->writeSVG(vm["placed-svg"].as<std::string>(), "scale=50 hide_routing");
         }
 
+        if (vm.count("load-checkpoint")) {
+            // Only now that the arch has finalised the placement (e.g. LUT pin remapping) do the pins that routing must
+            // reach match those in the checkpoint
+            ctx->readCheckpoint(vm["load-checkpoint"].as<std::string>(), /*placement=*/false, /*routing=*/true);
+            ctx->check();
+        }
+
         if (do_route) {
             run_script_hook("pre-route");
             bool saved_debug = ctx->debug;
@@ -492,6 +565,14 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
             log_error("Saving design failed.\n");
     }
 
+    if (vm.count("write-checkpoint")) {
+        std::string filename = vm["write-checkpoint"].as<std::string>();
+        std::ofstream f(filename, std::ios::binary);
+        if (!f)
+            log_error("Failed to open checkpoint file '%s' for writing.\n", filename.c_str());
+        ctx->writeCheckpoint(f);
+    }
+
     if (vm.count("sdf")) {
         std::string filename = vm["sdf"].as<std::string>();
         std::ofstream f(filename);
@@ -563,7 +644,7 @@ void CommandHandler::load_json(Context *ctx, std::string filename)
     setupArchContext(ctx);
     {
         std::ifstream f(filename);
-        if (!parse_json(f, filename, ctx))
+        if (!parse_json(f, filename, ctx, /*map_file=*/true))
             log_error("Loading design failed.\n");
     }
 }
@@ -103,6 +103,12 @@ struct Context : Arch, DeterministicRNG
     void writeReport(std::ostream &out) const;
     // --------------------------------------------------------------
 
+    // provided by checkpoint.cc
+    void writeCheckpoint(std::ostream &out);
+    // Placement is normally loaded first and routing only once the arch has finalised the placement
+    void readCheckpoint(const std::string &filename, bool placement = true, bool routing = true);
+    // --------------------------------------------------------------
+
     uint32_t checksum() const;
 
     void check() const;
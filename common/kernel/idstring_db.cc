@@ -0,0 +1,246 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "idstring_db.h"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+#ifndef NPNR_DISABLE_THREADS
+#include <boost/thread.hpp>
+#endif
+
+#include "log.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+IdStringDB::Table::Table(uint32_t capacity) : mask(capacity - 1), entries(new std::atomic<uint64_t>[capacity])
+{
+    for (uint32_t i = 0; i < capacity; i++)
+        entries[i].store(0, std::memory_order_relaxed);
+}
+
+IdStringDB::IdStringDB()
+        : shards(new Shard[num_shards]), chunks(new std::atomic<const std::string **>[max_chunks]), count(0)
+{
+    for (int i = 0; i < max_chunks; i++)
+        chunks[i].store(nullptr, std::memory_order_relaxed);
+    for (int i = 0; i < num_shards; i++) {
+        shards[i].tables.emplace_back(new Table(64));
+        shards[i].table.store(shards[i].tables.back().get(), std::memory_order_release);
+    }
+}
+
+IdStringDB::~IdStringDB()
+{
+    for (int i = 0; i < max_chunks; i++)
+        delete[] chunks[i].load(std::memory_order_relaxed);
+}
+
+uint64_t IdStringDB::hash(const std::string &s)
+{
+    // The top bits pick the shard and the bottom 32 are stored in the table, so mix std::hash well (it may only be
+    // 32 bits wide, or the identity on some platforms)
+    uint64_t h = uint64_t(std::hash<std::string>()(s));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+const std::string *&IdStringDB::slot(int idx)
+{
+    NPNR_ASSERT((idx >> chunk_bits) < max_chunks);
+    auto &chunk = chunks[idx >> chunk_bits];
+    const std::string **ptr = chunk.load(std::memory_order_acquire);
+    if (ptr == nullptr) {
+        // Several threads may race to allocate the same chunk; the first one wins
+        const std::string **fresh = new const std::string *[chunk_size]();
+        if (chunk.compare_exchange_strong(ptr, fresh, std::memory_order_acq_rel))
+            ptr = fresh;
+        else
+            delete[] fresh;
+    }
+    return ptr[idx & chunk_mask];
+}
+
+int IdStringDB::find(const Shard &shard, uint32_t h, const std::string &s) const
+{
+    // Tables are never more than half full, so there is always an empty slot to end the probe
+    const Table *table = shard.table.load(std::memory_order_acquire);
+    for (uint32_t i = h & table->mask;; i = (i + 1) & table->mask) {
+        uint64_t entry = table->entries[i].load(std::memory_order_acquire);
+        if (entry == 0)
+            return -1;
+        if (uint32_t(entry >> 32) == h) {
+            // The entry was published after the string slot was filled, so the string is visible here
+            int idx = int(uint32_t(entry)) - 1;
+            if (lookup(idx) == s)
+                return idx;
+        }
+    }
+}
+
+void IdStringDB::insert(Shard &shard, uint32_t h, const std::string &s, int idx)
+{
+    // Called with the shard mutex held
+    shard.strings.push_back(s);
+    slot(idx) = &shard.strings.back();
+    auto put = [](Table *table, uint64_t entry) {
+        uint32_t i = uint32_t(entry >> 32) & table->mask;
+        while (table->entries[i].load(std::memory_order_relaxed) != 0)
+            i = (i + 1) & table->mask;
+        table->entries[i].store(entry, std::memory_order_release);
+    };
+    Table *table = shard.table.load(std::memory_order_relaxed);
+    if (2 * (shard.used + 1) > table->mask + 1) {
+        Table *grown = new Table(2 * (table->mask + 1));
+        for (uint32_t i = 0; i <= table->mask; i++) {
+            uint64_t entry = table->entries[i].load(std::memory_order_relaxed);
+            if (entry != 0)
+                put(grown, entry);
+        }
+        shard.tables.emplace_back(grown);
+        shard.table.store(grown, std::memory_order_release);
+        table = grown;
+    }
+    put(table, (uint64_t(h) << 32) | uint32_t(idx + 1));
+    ++shard.used;
+}
+
+int IdStringDB::intern(const std::string &s)
+{
+    uint64_t h = hash(s);
+    Shard &sh = shard(h);
+    int idx = find(sh, uint32_t(h), s);
+    if (idx >= 0)
+        return idx;
+#ifndef NPNR_DISABLE_THREADS
+    std::lock_guard<std::mutex> lock(sh.mutex);
+#endif
+    // Another thread may have added it since the lock free lookup
+    idx = find(sh, uint32_t(h), s);
+    if (idx >= 0)
+        return idx;
+    idx = count.fetch_add(1, std::memory_order_acq_rel);
+    insert(sh, uint32_t(h), s, idx);
+    return idx;
+}
+
+void IdStringDB::add(const std::string &s, int idx)
+{
+    uint64_t h = hash(s);
+    Shard &sh = shard(h);
+#ifndef NPNR_DISABLE_THREADS
+    std::lock_guard<std::mutex> lock(sh.mutex);
+#endif
+    NPNR_ASSERT(size() == idx);
+    NPNR_ASSERT(find(sh, uint32_t(h), s) == -1);
+    // As in intern, the index is counted before it can be found
+    count.store(idx + 1, std::memory_order_release);
+    insert(sh, uint32_t(h), s, idx);
+}
+
+bool IdStringDB::contains(const std::string &s) const
+{
+    uint64_t h = hash(s);
+    return find(shard(h), uint32_t(h), s) != -1;
+}
+
+void idstring_benchmark(int max_threads)
+{
+    const int names_per_thread = 250000;
+    log_info("IdString interning benchmark, %d names per thread:\n", names_per_thread);
+    {
+        // The unsynchronised map and vector that IdStringDB replaced, for reference
+        std::vector<std::string> names;
+        names.reserve(names_per_thread);
+        for (int i = 0; i < names_per_thread; i++)
+            names.push_back(stringf("$bench$%d$%d", 0, i));
+        std::unordered_map<std::string, int> str_to_idx;
+        std::vector<const std::string *> idx_to_str;
+        auto run_pass = [&](bool verify) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (auto &n : names) {
+                // Same as the old IdString::set
+                int idx;
+                auto found = str_to_idx.find(n);
+                if (found == str_to_idx.end()) {
+                    idx = int(idx_to_str.size());
+                    auto ins = str_to_idx.insert({n, idx});
+                    idx_to_str.push_back(&ins.first->first);
+                } else {
+                    idx = found->second;
+                }
+                if (verify)
+                    NPNR_ASSERT(*idx_to_str.at(idx) == n);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double>(end - start).count();
+        };
+        double insert_time = run_pass(false);
+        double lookup_time = run_pass(true);
+        log_info("    baseline unsynchronised map: insert %6.2f Mnames/s, lookup %6.2f Mnames/s\n",
+                 names_per_thread / insert_time / 1e6, names_per_thread / lookup_time / 1e6);
+    }
+    for (int threads = 1; threads <= std::max(1, max_threads); threads *= 2) {
+        IdStringDB db;
+        std::vector<std::vector<std::string>> names(threads);
+        for (int t = 0; t < threads; t++) {
+            names.at(t).reserve(names_per_thread);
+            for (int i = 0; i < names_per_thread; i++)
+                names.at(t).push_back(stringf("$bench$%d$%d", t, i));
+        }
+        // Each thread first adds its own names and then looks all of them up again
+        auto run_pass = [&](bool verify) {
+            auto start = std::chrono::high_resolution_clock::now();
+            auto worker = [&](int t) {
+                for (auto &n : names.at(t)) {
+                    int idx = db.intern(n);
+                    if (verify)
+                        NPNR_ASSERT(db.lookup(idx) == n);
+                }
+            };
+#ifndef NPNR_DISABLE_THREADS
+            std::vector<boost::thread> workers;
+            for (int t = 1; t < threads; t++)
+                workers.emplace_back(worker, t);
+            worker(0);
+            for (auto &w : workers)
+                w.join();
+#else
+            for (int t = 0; t < threads; t++)
+                worker(t);
+#endif
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double>(end - start).count();
+        };
+        double insert_time = run_pass(false);
+        double lookup_time = run_pass(true);
+        NPNR_ASSERT(db.size() == threads * names_per_thread);
+        double total = double(threads) * names_per_thread;
+        log_info("    %2d threads: insert %6.2f Mnames/s, lookup %6.2f Mnames/s\n", threads,
+                 total / insert_time / 1e6, total / lookup_time / 1e6);
+    }
+}
+
+NEXTPNR_NAMESPACE_END
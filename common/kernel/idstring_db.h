@@ -0,0 +1,112 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef IDSTRING_DB_H
+#define IDSTRING_DB_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#ifndef NPNR_DISABLE_THREADS
+#include <mutex>
+#endif
+
+#include "nextpnr_assertions.h"
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// The string table behind IdString, safe for concurrent lookup and insertion.
+//
+// The string to index map is split into shards. Each shard is an open-addressed hash table of (hash, index) entries
+// that are published atomically, so finding a name that already exists takes no lock at all; only adding a new name
+// takes the shard's mutex. A table that fills up is replaced by a larger copy, and the old one is kept until
+// destruction as readers may still be probing it. The index to string table is a list of fixed size chunks that
+// never move once allocated, so looking up the string of an existing IdString is lock free too.
+//
+// Indices are allocated in insertion order; they are only reproducible between runs if names are created from a
+// single thread, or in a fixed order.
+struct IdStringDB
+{
+    IdStringDB();
+    ~IdStringDB();
+    IdStringDB(const IdStringDB &) = delete;
+    IdStringDB &operator=(const IdStringDB &) = delete;
+
+    // Return the index of s, adding it if it does not exist yet
+    int intern(const std::string &s);
+    // Add s with a fixed index, which must be the next unused one
+    void add(const std::string &s, int idx);
+    bool contains(const std::string &s) const;
+
+    const std::string &lookup(int idx) const
+    {
+        NPNR_ASSERT(idx >= 0 && idx < size());
+        return *chunks[idx >> chunk_bits].load(std::memory_order_acquire)[idx & chunk_mask];
+    }
+
+    int size() const { return count.load(std::memory_order_acquire); }
+
+  private:
+    static constexpr int chunk_bits = 16;
+    static constexpr int chunk_size = 1 << chunk_bits;
+    static constexpr int chunk_mask = chunk_size - 1;
+    static constexpr int max_chunks = 1 << 15;
+    static constexpr int shard_bits = 6;
+    static constexpr int num_shards = 1 << shard_bits;
+
+    // Entries are (32 bit hash << 32) | (index + 1), with 0 marking an empty slot
+    struct Table
+    {
+        explicit Table(uint32_t capacity);
+        uint32_t mask;
+        std::unique_ptr<std::atomic<uint64_t>[]> entries;
+    };
+
+    struct Shard
+    {
+#ifndef NPNR_DISABLE_THREADS
+        std::mutex mutex;
+#endif
+        std::atomic<Table *> table{nullptr};
+        uint32_t used = 0;
+        std::vector<std::unique_ptr<Table>> tables;
+        // Owns the strings, a deque so they never move
+        std::deque<std::string> strings;
+    };
+
+    static uint64_t hash(const std::string &s);
+    Shard &shard(uint64_t h) const { return shards[h >> (64 - shard_bits)]; }
+    int find(const Shard &shard, uint32_t h, const std::string &s) const;
+    void insert(Shard &shard, uint32_t h, const std::string &s, int idx);
+    const std::string *&slot(int idx);
+
+    std::unique_ptr<Shard[]> shards;
+    std::unique_ptr<std::atomic<const std::string **>[]> chunks;
+    std::atomic<int> count;
+};
+
+// Measure interning and lookup throughput of IdStringDB for 1, 2, 4 ... max_threads threads
+void idstring_benchmark(int max_threads);
+
+NEXTPNR_NAMESPACE_END
+
+#endif /* IDSTRING_DB_H */
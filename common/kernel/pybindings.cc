@@ -52,7 +52,7 @@ void parse_json_shim(std::string filename, Context &d)
     std::ifstream inf(filename);
     if (!inf)
         throw std::runtime_error("failed to open file " + filename);
-    parse_json(inf, filename, &d);
+    parse_json(inf, filename, &d, /*map_file=*/true);
 }
 
 // Create a new Chip and load design from json file
@@ -22,10 +22,12 @@
 #include <algorithm>
 #include <boost/range/adaptor/reversed.hpp>
 #include <deque>
+#include <iterator>
 #include <map>
 #include <utility>
 #include "log.h"
 #include "util.h"
+#include "worker_pool.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
@@ -33,34 +35,65 @@ namespace {
 const char *edge_name(ClockEdge edge) { return (edge == FALLING_EDGE) ? "negedge" : "posedge"; }
 } // namespace
 
+TimingAnalyser::TimingAnalyser(Context *ctx) : ctx(ctx) {}
+
+TimingAnalyser::~TimingAnalyser() = default;
+
 void TimingAnalyser::setup()
 {
+    incremental = ctx->setting<bool>("timing/incremental", true);
+    check_incremental = ctx->setting<bool>("timing/checkIncremental", false);
+    threads = ctx->setting<int>("threads", 8);
     init_ports();
     get_cell_delays();
     topo_sort();
+    build_graph();
+    build_levels();
     setup_port_domains();
     identify_related_domains();
+    times_valid = false;
     run();
 }
 
 void TimingAnalyser::run(bool update_route_delays)
 {
-    reset_times();
     if (update_route_delays)
         get_route_delays();
+    if (incremental && times_valid && !have_loops) {
+        if (dirty_ports.empty())
+            return;
+        if (run_incremental()) {
+            if (check_incremental)
+                check_incremental_results();
+            return;
+        }
+    }
+    run_full();
+}
+
+void TimingAnalyser::run_full()
+{
+    reset_times();
     walk_forward();
     walk_backward();
     compute_slack();
     compute_criticality();
+    clear_dirty();
+    times_valid = true;
 }
 
 void TimingAnalyser::init_ports()
 {
     // Per cell port structures
+    ports.clear();
+    port_to_id.clear();
+    dirty_ports.clear();
     for (auto &cell : ctx->cells) {
         CellInfo *ci = cell.second.get();
         for (auto &port : ci->ports) {
-            auto &data = ports[CellPortKey(ci->name, port.first)];
+            port_to_id[CellPortKey(ci->name, port.first)] = int(ports.size());
+            ports.emplace_back();
+            auto &data = ports.back();
             data.type = port.second.type;
             data.cell_port = CellPortKey(ci->name, port.first);
         }
@@ -69,12 +102,11 @@ void TimingAnalyser::init_ports()
 
 void TimingAnalyser::get_cell_delays()
 {
-    for (auto &port : ports) {
-        CellInfo *ci = cell_info(port.first);
-        auto &pi = port_info(port.first);
-        auto &pd = port.second;
+    for (auto &pd : ports) {
+        CellInfo *ci = cell_info(pd.cell_port);
+        auto &pi = port_info(pd.cell_port);
 
-        IdString name = port.first.port;
+        IdString name = pd.cell_port.port;
         // Ignore dangling ports altogether for timing purposes
         if (!pi.net)
             continue;
@@ -142,35 +174,56 @@ void TimingAnalyser::get_route_delays()
         for (auto &usr : ni->users) {
             if (usr.cell->bel == BelId())
                 continue;
-            ports.at(CellPortKey(usr)).route_delay = DelayPair(ctx->getNetinfoRouteDelay(ni, usr));
+            set_route_delay(CellPortKey(usr), DelayPair(ctx->getNetinfoRouteDelay(ni, usr)));
         }
     }
 }
 
-void TimingAnalyser::set_route_delay(CellPortKey port, DelayPair value) { ports.at(port).route_delay = value; }
+void TimingAnalyser::set_route_delay(CellPortKey port, DelayPair value)
+{
+    int id = port_to_id.at(port);
+    auto &pd = ports.at(id);
+    if (pd.route_delay.min_delay == value.min_delay && pd.route_delay.max_delay == value.max_delay)
+        return;
+    pd.route_delay = value;
+    if (!pd.route_dirty) {
+        pd.route_dirty = true;
+        dirty_ports.push_back(id);
+    }
+}
+
+void TimingAnalyser::clear_dirty()
+{
+    for (int p : dirty_ports)
+        ports.at(p).route_dirty = false;
+    dirty_ports.clear();
+}
+
+template <typename Tfunc> void TimingAnalyser::for_each_fanout(int port, Tfunc func)
+{
+    auto &pd = ports.at(port);
+    if (pd.type == PORT_OUT) {
+        // output: routing arcs to the net users
+        const NetInfo *net = port_info(pd.cell_port).net;
+        if (net != nullptr)
+            for (auto &usr : net->users)
+                func(port_to_id.at(CellPortKey(usr)), true, DelayPair(0));
+    } else if (pd.type == PORT_IN) {
+        // inputs: combinational arcs through the cell
+        for (auto &fanout : pd.cell_arcs)
+            if (fanout.type == CellArc::COMBINATIONAL)
+                func(port_to_id.at(CellPortKey(pd.cell_port.cell, fanout.other_port)), false,
+                     fanout.value.delayPair());
+    }
+}
 
 void TimingAnalyser::topo_sort()
 {
-    TopoSort<CellPortKey> topo;
-    for (auto &port : ports) {
-        auto &pd = port.second;
+    TopoSort<int> topo;
+    for (int i = 0; i < int(ports.size()); i++) {
         // All ports are nodes
-        topo.node(port.first);
-        if (pd.type == PORT_IN) {
-            // inputs: combinational arcs through the cell are edges
-            for (auto &arc : pd.cell_arcs) {
-                if (arc.type != CellArc::COMBINATIONAL)
-                    continue;
-                topo.edge(port.first, CellPortKey(port.first.cell, arc.other_port));
-            }
-        } else if (pd.type == PORT_OUT) {
-            // output: routing arcs are edges
-            const NetInfo *pn = port_info(port.first).net;
-            if (pn != nullptr) {
-                for (auto &usr : pn->users)
-                    topo.edge(port.first, CellPortKey(usr));
-            }
-        }
+        topo.node(i);
+        for_each_fanout(i, [&](int target, bool, DelayPair) { topo.edge(i, target); });
     }
     bool no_loops = topo.sort();
     if (!no_loops && verbose_mode) {
@@ -178,14 +231,51 @@ void TimingAnalyser::topo_sort()
         int i = 0;
         for (auto &loop : topo.loops) {
             log_info("    loop %d:\n", ++i);
-            for (auto &port : loop) {
+            for (int p : loop) {
+                auto &port = ports.at(p).cell_port;
                 log_info("        %s.%s (%s)\n", ctx->nameOf(port.cell), ctx->nameOf(port.port),
                          ctx->nameOf(port_info(port).net));
             }
         }
     }
     have_loops = !no_loops;
-    std::swap(topological_order, topo.sorted);
+    // Renumber ports in topological order, so that walks go through memory in order
+    std::vector<PerPort> sorted_ports;
+    sorted_ports.reserve(ports.size());
+    for (int p : topo.sorted) {
+        port_to_id.at(ports.at(p).cell_port) = int(sorted_ports.size());
+        sorted_ports.push_back(std::move(ports.at(p)));
+    }
+    std::swap(ports, sorted_ports);
+}
+
+void TimingAnalyser::build_graph()
+{
+    int n = int(ports.size());
+    fanin_offsets.assign(n + 1, 0);
+    fanout_offsets.assign(n + 1, 0);
+    for (int i = 0; i < n; i++)
+        for_each_fanout(i, [&](int target, bool, DelayPair) {
+            fanout_offsets.at(i + 1)++;
+            fanin_offsets.at(target + 1)++;
+        });
+    for (int i = 0; i < n; i++) {
+        fanout_offsets.at(i + 1) += fanout_offsets.at(i);
+        fanin_offsets.at(i + 1) += fanin_offsets.at(i);
+    }
+    fanout_edges.resize(fanout_offsets.back());
+    fanin_edges.resize(fanin_offsets.back());
+    std::vector<int> fill(fanin_offsets.begin(), fanin_offsets.end() - 1);
+    // Visiting sources in id order leaves each fanin list sorted by source
+    for (int i = 0; i < n; i++) {
+        int out = fanout_offsets.at(i);
+        for_each_fanout(i, [&](int target, bool is_route, DelayPair delay) {
+            fanout_edges.at(out++) = TimingEdge{target, is_route, delay};
+            fanin_edges.at(fill.at(target)++) = TimingEdge{i, is_route, delay};
+        });
+        std::stable_sort(fanout_edges.begin() + fanout_offsets.at(i), fanout_edges.begin() + out,
+                         [](const TimingEdge &a, const TimingEdge &b) { return a.port < b.port; });
+    }
 }
 
 void TimingAnalyser::setup_port_domains()
@@ -194,78 +284,75 @@ void TimingAnalyser::setup_port_domains()
         d.startpoints.clear();
         d.endpoints.clear();
     }
+    int n = int(ports.size());
+    // Domains are gathered per port and then flattened into the arrival/required tables
+    std::vector<std::vector<domain_id_t>> arrival_doms(n), required_doms(n);
+    auto copy_domains = [&](std::vector<domain_id_t> &from, std::vector<domain_id_t> &to) {
+        for (domain_id_t dom : from) {
+            if (std::find(to.begin(), to.end(), dom) != to.end())
+                continue;
+            to.push_back(dom);
+            updated_domains = true;
+        }
+    };
     // Go forward through the topological order (domains from the PoV of arrival time)
     bool first_iter = true;
     do {
         updated_domains = false;
-        for (auto port : topological_order) {
-            auto &pd = ports.at(port);
-            auto &pi = port_info(port);
-            if (pi.type == PORT_OUT) {
-                if (first_iter) {
-                    for (auto &fanin : pd.cell_arcs) {
-                        if (fanin.type != CellArc::CLK_TO_Q)
-                            continue;
-                        // registered outputs are startpoints
-                        auto dom = domain_id(port.cell, fanin.other_port, fanin.edge);
-                        // create per-domain data
-                        pd.arrival[dom];
-                        domains.at(dom).startpoints.emplace_back(port, fanin.other_port);
-                    }
-                }
-                // copy domains across routing
-                if (pi.net != nullptr)
-                    for (auto &usr : pi.net->users)
-                        copy_domains(port, CellPortKey(usr), false);
-            } else {
-                // copy domains from input to output
-                for (auto &fanout : pd.cell_arcs) {
-                    if (fanout.type != CellArc::COMBINATIONAL)
+        for (int p = 0; p < n; p++) {
+            auto &pd = ports.at(p);
+            if (first_iter && pd.type == PORT_OUT) {
+                for (auto &fanin : pd.cell_arcs) {
+                    if (fanin.type != CellArc::CLK_TO_Q)
                         continue;
-                    copy_domains(port, CellPortKey(port.cell, fanout.other_port), false);
+                    // registered outputs are startpoints
+                    auto dom = domain_id(pd.cell_port.cell, fanin.other_port, fanin.edge);
+                    // create per-domain data
+                    if (std::find(arrival_doms.at(p).begin(), arrival_doms.at(p).end(), dom) ==
+                        arrival_doms.at(p).end())
+                        arrival_doms.at(p).push_back(dom);
+                    int clock = port_to_id.at(CellPortKey(pd.cell_port.cell, fanin.other_port));
+                    domains.at(dom).startpoints.emplace_back(p, clock);
                 }
             }
+            // copy domains across routing and from input to output
+            for (int i = fanout_offsets.at(p); i < fanout_offsets.at(p + 1); i++)
+                copy_domains(arrival_doms.at(p), arrival_doms.at(fanout_edges.at(i).port));
         }
         // Go backward through the topological order (domains from the PoV of required time)
-        for (auto port : reversed_range(topological_order)) {
-            auto &pd = ports.at(port);
-            auto &pi = port_info(port);
-            if (pi.type == PORT_OUT) {
-                // copy domains from output to input
-                for (auto &fanin : pd.cell_arcs) {
-                    if (fanin.type != CellArc::COMBINATIONAL)
+        for (int p = n - 1; p >= 0; p--) {
+            auto &pd = ports.at(p);
+            if (first_iter && pd.type == PORT_IN) {
+                for (auto &fanout : pd.cell_arcs) {
+                    if (fanout.type != CellArc::SETUP)
                         continue;
-                    copy_domains(port, CellPortKey(port.cell, fanin.other_port), true);
-                }
-            } else {
-                if (first_iter) {
-                    for (auto &fanout : pd.cell_arcs) {
-                        if (fanout.type != CellArc::SETUP)
-                            continue;
-                        // registered inputs are endpoints
-                        auto dom = domain_id(port.cell, fanout.other_port, fanout.edge);
-                        // create per-domain data
-                        pd.required[dom];
-                        domains.at(dom).endpoints.emplace_back(port, fanout.other_port);
-                    }
+                    // registered inputs are endpoints
+                    auto dom = domain_id(pd.cell_port.cell, fanout.other_port, fanout.edge);
+                    // create per-domain data
+                    if (std::find(required_doms.at(p).begin(), required_doms.at(p).end(), dom) ==
+                        required_doms.at(p).end())
+                        required_doms.at(p).push_back(dom);
+                    int clock = port_to_id.at(CellPortKey(pd.cell_port.cell, fanout.other_port));
+                    domains.at(dom).endpoints.emplace_back(p, clock);
                 }
-                // copy port to driver
-                if (pi.net != nullptr && pi.net->driver.cell != nullptr)
-                    copy_domains(port, CellPortKey(pi.net->driver), true);
             }
-        }
-        // Iterate over ports and find domain paris
-        for (auto port : topological_order) {
-            auto &pd = ports.at(port);
-            for (auto &arr : pd.arrival)
-                for (auto &req : pd.required) {
-                    pd.domain_pairs[domain_pair_id(arr.first, req.first)];
-                }
+            // copy domains from output to input and from port to driver
+            for (int i = fanin_offsets.at(p); i < fanin_offsets.at(p + 1); i++)
+                copy_domains(required_doms.at(p), required_doms.at(fanin_edges.at(i).port));
         }
         first_iter = false;
         // If there are loops, repeat the process until a fixed point is reached, as there might be unusual ways to
         // visit points, which would result in a missing domain key and therefore crash later on
     } while (have_loops && updated_domains);
+    arrival.build(arrival_doms);
+    required.build(required_doms);
+    // Iterate over ports and find domain pairs
+    std::vector<std::vector<domain_id_t>> pair_doms(n);
+    for (int p = 0; p < n; p++)
+        for (int a = arrival.begin(p); a < arrival.end(p); a++)
+            for (int r = required.begin(p); r < required.end(p); r++)
+                pair_doms.at(p).push_back(domain_pair_id(arrival.domain.at(a), required.domain.at(r)));
+    port_domain_pairs.build(pair_doms);
     for (auto &dp : domain_pairs) {
         auto &launch_data = domains.at(dp.key.launch);
         auto &capture_data = domains.at(dp.key.capture);
@@ -443,172 +530,415 @@ void TimingAnalyser::identify_related_domains()
 
 void TimingAnalyser::reset_times()
 {
-    for (auto &port : ports) {
-        auto do_reset = [&](dict<domain_id_t, ArrivReqTime> &times) {
-            for (auto &t : times) {
-                t.second.value = init_delay;
-                t.second.path_length = 0;
-                t.second.bwd_min = CellPortKey();
-                t.second.bwd_max = CellPortKey();
-            }
-        };
-        do_reset(port.second.arrival);
-        do_reset(port.second.required);
-        for (auto &dp : port.second.domain_pairs) {
-            dp.second.setup_slack = std::numeric_limits<delay_t>::max();
-            dp.second.hold_slack = std::numeric_limits<delay_t>::max();
-            dp.second.max_path_length = 0;
-            dp.second.criticality = 0;
-            dp.second.budget = 0;
+    auto do_reset = [&](std::vector<ArrivReqTime> &times) {
+        for (auto &t : times) {
+            t.value = init_delay;
+            t.path_length = 0;
+            t.bwd_min = -1;
+            t.bwd_max = -1;
         }
-        port.second.worst_crit = 0;
-        port.second.worst_setup_slack = std::numeric_limits<delay_t>::max();
-        port.second.worst_hold_slack = std::numeric_limits<delay_t>::max();
+    };
+    do_reset(arrival.value);
+    do_reset(required.value);
+    for (auto &dp : port_domain_pairs.value) {
+        dp.setup_slack = std::numeric_limits<delay_t>::max();
+        dp.hold_slack = std::numeric_limits<delay_t>::max();
+        dp.max_path_length = 0;
+        dp.criticality = 0;
+        dp.budget = 0;
+    }
+    for (auto &pd : ports) {
+        pd.worst_crit = 0;
+        pd.worst_setup_slack = std::numeric_limits<delay_t>::max();
+        pd.worst_hold_slack = std::numeric_limits<delay_t>::max();
     }
 }
 
-void TimingAnalyser::set_arrival_time(CellPortKey target, domain_id_t domain, DelayPair arrival, int path_length,
-                                      CellPortKey prev)
+void TimingAnalyser::set_arrival_time(int target, domain_id_t domain, DelayPair arrival_time, int path_length,
+                                      int prev)
 {
-    auto &arr = ports.at(target).arrival.at(domain);
-    if (arrival.max_delay > arr.value.max_delay) {
-        arr.value.max_delay = arrival.max_delay;
+    int idx = arrival.find(target, domain);
+    NPNR_ASSERT(idx != -1);
+    auto &arr = arrival.value[idx];
+    if (arrival_time.max_delay > arr.value.max_delay) {
+        arr.value.max_delay = arrival_time.max_delay;
         arr.bwd_max = prev;
     }
-    if (!setup_only && (arrival.min_delay < arr.value.min_delay)) {
-        arr.value.min_delay = arrival.min_delay;
+    if (!setup_only && (arrival_time.min_delay < arr.value.min_delay)) {
+        arr.value.min_delay = arrival_time.min_delay;
         arr.bwd_min = prev;
     }
     arr.path_length = std::max(arr.path_length, path_length);
 }
 
-void TimingAnalyser::set_required_time(CellPortKey target, domain_id_t domain, DelayPair required, int path_length,
-                                       CellPortKey prev)
+void TimingAnalyser::set_required_time(int target, domain_id_t domain, DelayPair required_time, int path_length,
+                                       int prev)
 {
-    auto &req = ports.at(target).required.at(domain);
-    if (required.min_delay < req.value.min_delay) {
-        req.value.min_delay = required.min_delay;
+    int idx = required.find(target, domain);
+    NPNR_ASSERT(idx != -1);
+    auto &req = required.value[idx];
+    if (required_time.min_delay < req.value.min_delay) {
+        req.value.min_delay = required_time.min_delay;
         req.bwd_min = prev;
     }
-    if (!setup_only && (required.max_delay > req.value.max_delay)) {
-        req.value.max_delay = required.max_delay;
+    if (!setup_only && (required_time.max_delay > req.value.max_delay)) {
+        req.value.max_delay = required_time.max_delay;
         req.bwd_max = prev;
     }
     req.path_length = std::max(req.path_length, path_length);
 }
 
-void TimingAnalyser::walk_forward()
+void TimingAnalyser::init_startpoint(domain_id_t dom_id, const std::pair<int, int> &sp)
 {
-    // Assign initial arrival time to domain startpoints
-    for (domain_id_t dom_id = 0; dom_id < domain_id_t(domains.size()); ++dom_id) {
-        auto &dom = domains.at(dom_id);
-        for (auto &sp : dom.startpoints) {
-            auto &pd = ports.at(sp.first);
-            DelayPair init_arrival(0);
-            CellPortKey clock_key;
-            // TODO: clock routing delay, if analysis of that is enabled
-            if (sp.second != IdString()) {
-                // clocked startpoints have a clock-to-out time
-                for (auto &fanin : pd.cell_arcs) {
-                    if (fanin.type == CellArc::CLK_TO_Q && fanin.other_port == sp.second) {
-                        init_arrival = init_arrival + fanin.value.delayPair();
-                        break;
-                    }
-                }
-                clock_key = CellPortKey(sp.first.cell, sp.second);
-            }
-            set_arrival_time(sp.first, dom_id, init_arrival, 1, clock_key);
+    auto &pd = ports.at(sp.first);
+    IdString clock_port = ports.at(sp.second).cell_port.port;
+    DelayPair init_arrival(0);
+    // TODO: clock routing delay, if analysis of that is enabled
+    // clocked startpoints have a clock-to-out time
+    for (auto &fanin : pd.cell_arcs) {
+        if (fanin.type == CellArc::CLK_TO_Q && fanin.other_port == clock_port) {
+            init_arrival = init_arrival + fanin.value.delayPair();
+            break;
         }
     }
-    // Walk forward in topological order
-    for (auto p : topological_order) {
-        auto &pd = ports.at(p);
-        for (auto &arr : pd.arrival) {
-            if (pd.type == PORT_OUT) {
-                // Output port: propagate delay through net, adding route delay
-                NetInfo *net = port_info(p).net;
-                if (net != nullptr)
-                    for (auto &usr : net->users) {
-                        CellPortKey usr_key(usr);
-                        auto &usr_pd = ports.at(usr_key);
-                        set_arrival_time(usr_key, arr.first, arr.second.value + usr_pd.route_delay,
-                                         arr.second.path_length, p);
-                    }
-            } else if (pd.type == PORT_IN) {
-                // Input port; propagate delay through cell, adding combinational delay
-                for (auto &fanout : pd.cell_arcs) {
-                    if (fanout.type != CellArc::COMBINATIONAL)
-                        continue;
-                    set_arrival_time(CellPortKey(p.cell, fanout.other_port), arr.first,
-                                     arr.second.value + fanout.value.delayPair(), arr.second.path_length + 1, p);
-                }
-            }
+    set_arrival_time(sp.first, dom_id, init_arrival, 1, sp.second);
+}
+
+void TimingAnalyser::init_endpoint(domain_id_t dom_id, const std::pair<int, int> &ep)
+{
+    auto &pd = ports.at(ep.first);
+    IdString clock_port = ports.at(ep.second).cell_port.port;
+    DelayPair init_setuphold(0);
+    // TODO: clock routing delay, if analysis of that is enabled
+    // Add setup/hold time, if this endpoint is clocked
+    for (auto &fanin : pd.cell_arcs) {
+        if (fanin.type == CellArc::SETUP && fanin.other_port == clock_port)
+            init_setuphold.min_delay -= fanin.value.maxDelay();
+        if (fanin.type == CellArc::HOLD && fanin.other_port == clock_port)
+            init_setuphold.max_delay -= fanin.value.maxDelay();
+    }
+    set_required_time(ep.first, dom_id, init_setuphold, 1, ep.second);
+}
+
+void TimingAnalyser::propagate_arrival(int p)
+{
+    for (int i = fanout_offsets[p]; i < fanout_offsets[p + 1]; i++) {
+        const auto &e = fanout_edges[i];
+        // Routing arcs add the route delay of the user; cell arcs the combinational delay
+        DelayPair delay = e.is_route ? ports[e.port].route_delay : e.cell_delay;
+        int length = e.is_route ? 0 : 1;
+        for (int a = arrival.begin(p); a < arrival.end(p); a++) {
+            const auto &arr = arrival.value[a];
+            set_arrival_time(e.port, arrival.domain[a], arr.value + delay, arr.path_length + length, p);
         }
     }
 }
 
+void TimingAnalyser::propagate_required(int p)
+{
+    for (int i = fanin_offsets[p]; i < fanin_offsets[p + 1]; i++) {
+        const auto &e = fanin_edges[i];
+        delay_t delay = e.is_route ? ports[p].route_delay.maxDelay() : e.cell_delay.maxDelay();
+        int length = e.is_route ? 0 : 1;
+        for (int r = required.begin(p); r < required.end(p); r++) {
+            const auto &req = required.value[r];
+            set_required_time(e.port, required.domain[r], req.value - DelayPair(delay), req.path_length + length, p);
+        }
+    }
+}
+
+void TimingAnalyser::pull_arrival(int p)
+{
+    // Fanin is visited in topological order, the same order the serial walk pushes in, so that ties resolve identically
+    for (int i = fanin_offsets[p]; i < fanin_offsets[p + 1]; i++) {
+        const auto &e = fanin_edges[i];
+        DelayPair delay = e.is_route ? ports[p].route_delay : e.cell_delay;
+        int length = e.is_route ? 0 : 1;
+        for (int a = arrival.begin(e.port); a < arrival.end(e.port); a++) {
+            const auto &arr = arrival.value[a];
+            set_arrival_time(p, arrival.domain[a], arr.value + delay, arr.path_length + length, e.port);
+        }
+    }
+}
+
+void TimingAnalyser::pull_required(int p)
+{
+    // Likewise in reverse topological order for the backward walk
+    for (int i = fanout_offsets[p + 1] - 1; i >= fanout_offsets[p]; i--) {
+        const auto &e = fanout_edges[i];
+        delay_t delay = e.is_route ? ports[e.port].route_delay.maxDelay() : e.cell_delay.maxDelay();
+        int length = e.is_route ? 0 : 1;
+        for (int r = required.begin(e.port); r < required.end(e.port); r++) {
+            const auto &req = required.value[r];
+            set_required_time(p, required.domain[r], req.value - DelayPair(delay), req.path_length + length, e.port);
+        }
+    }
+}
+
+template <typename Tfunc> void TimingAnalyser::for_each_level(bool backward, Tfunc func)
+{
+    int num_levels = int(level_offsets.size()) - 1;
+    // Group levels into steps: a run of small levels is done serially by one thread, a large level is split between
+    // all threads. Every port only writes its own times, so the only synchronisation needed is between steps.
+    const int min_parallel_level = 512;
+    std::vector<std::pair<int, bool>> steps; // (last level in step, parallel)
+    for (int i = 0; i < num_levels; i++) {
+        int level = backward ? (num_levels - 1 - i) : i;
+        bool parallel = (level_offsets.at(level + 1) - level_offsets.at(level)) >= min_parallel_level;
+        if (parallel || steps.empty() || steps.back().second)
+            steps.emplace_back(i, parallel);
+        else
+            steps.back().first = i;
+    }
+    auto do_levels = [&](int first, int last, int tid, int n_threads) {
+        for (int i = first; i <= last; i++) {
+            int level = backward ? (num_levels - 1 - i) : i;
+            int begin = level_offsets.at(level), end = level_offsets.at(level + 1);
+            int chunk = (end - begin + n_threads - 1) / n_threads;
+            for (int j = begin + tid * chunk; j < std::min(end, begin + (tid + 1) * chunk); j++)
+                func(level_ports.at(j));
+        }
+    };
+#ifndef NPNR_DISABLE_THREADS
+    // Handing a level out to the workers costs a wakeup and a wait per step, so only bother when there is enough
+    // parallel work in the whole walk for that to pay off
+    const int min_parallel_ports = 16384;
+    int parallel_ports = 0, first = 0;
+    for (auto &step : steps) {
+        if (step.second)
+            parallel_ports += level_offsets.at(backward ? (num_levels - first) : (step.first + 1)) -
+                              level_offsets.at(backward ? (num_levels - 1 - step.first) : first);
+        first = step.first + 1;
+    }
+    int n_threads = std::max(1, threads);
+    if (n_threads > 1 && parallel_ports >= min_parallel_ports) {
+        if (!workers || workers->size() != n_threads)
+            workers.reset(new WorkerPool(n_threads));
+        first = 0;
+        for (auto &step : steps) {
+            if (step.second)
+                workers->run([&](int tid) { do_levels(first, step.first, tid, n_threads); });
+            else
+                do_levels(first, step.first, 0, 1);
+            first = step.first + 1;
+        }
+        return;
+    }
+#endif
+    do_levels(0, num_levels - 1, 0, 1);
+}
+
+void TimingAnalyser::walk_forward()
+{
+    // Assign initial arrival time to domain startpoints
+    for (domain_id_t dom_id = 0; dom_id < domain_id_t(domains.size()); ++dom_id)
+        for (auto &sp : domains.at(dom_id).startpoints)
+            init_startpoint(dom_id, sp);
+    if (have_loops) {
+        // Walk forward in topological order
+        for (int p = 0; p < int(ports.size()); p++)
+            propagate_arrival(p);
+    } else {
+        // Walk forward level by level, each port gathering from its fanin
+        for_each_level(false, [&](int p) { pull_arrival(p); });
+    }
+}
+
 void TimingAnalyser::walk_backward()
 {
     // Assign initial required time to domain endpoints
     // Note that clock frequency will be considered later in the analysis for, for now all required times are normalised
     // to 0ns
-    for (domain_id_t dom_id = 0; dom_id < domain_id_t(domains.size()); ++dom_id) {
-        auto &dom = domains.at(dom_id);
-        for (auto &ep : dom.endpoints) {
-            auto &pd = ports.at(ep.first);
-            DelayPair init_setuphold(0);
-            CellPortKey clock_key;
-            // TODO: clock routing delay, if analysis of that is enabled
-            if (ep.second != IdString()) {
-                // Add setup/hold time, if this endpoint is clocked
-                for (auto &fanin : pd.cell_arcs) {
-                    if (fanin.type == CellArc::SETUP && fanin.other_port == ep.second)
-                        init_setuphold.min_delay -= fanin.value.maxDelay();
-                    if (fanin.type == CellArc::HOLD && fanin.other_port == ep.second)
-                        init_setuphold.max_delay -= fanin.value.maxDelay();
-                }
-                clock_key = CellPortKey(ep.first.cell, ep.second);
-            }
-            set_required_time(ep.first, dom_id, init_setuphold, 1, clock_key);
-        }
+    for (domain_id_t dom_id = 0; dom_id < domain_id_t(domains.size()); ++dom_id)
+        for (auto &ep : domains.at(dom_id).endpoints)
+            init_endpoint(dom_id, ep);
+    if (have_loops) {
+        // Walk backwards in topological order
+        for (int p = int(ports.size()) - 1; p >= 0; p--)
+            propagate_required(p);
+    } else {
+        for_each_level(true, [&](int p) { pull_required(p); });
     }
-    // Walk backwards in topological order
-    for (auto p : reversed_range(topological_order)) {
-        auto &pd = ports.at(p);
-        for (auto &req : pd.required) {
-            if (pd.type == PORT_IN) {
-                // Input port: propagate delay back through net, subtracting route delay
-                NetInfo *net = port_info(p).net;
-                if (net != nullptr && net->driver.cell != nullptr)
-                    set_required_time(CellPortKey(net->driver), req.first,
-                                      req.second.value - DelayPair(pd.route_delay.maxDelay()), req.second.path_length,
-                                      p);
-            } else if (pd.type == PORT_OUT) {
-                // Output port : propagate delay back through cell, subtracting combinational delay
-                for (auto &fanin : pd.cell_arcs) {
-                    if (fanin.type != CellArc::COMBINATIONAL)
-                        continue;
-                    set_required_time(CellPortKey(p.cell, fanin.other_port), req.first,
-                                      req.second.value - DelayPair(fanin.value.maxDelay()), req.second.path_length + 1,
-                                      p);
-                }
-            }
+}
+
+void TimingAnalyser::build_levels()
+{
+    int n = int(ports.size());
+    level_ports.clear();
+    level_offsets.clear();
+    if (have_loops)
+        return;
+    // The level of a port is the length of the longest path to it, so all of a port's fanin is in earlier levels
+    std::vector<int> level(n, 0);
+    int num_levels = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = fanin_offsets.at(i); j < fanin_offsets.at(i + 1); j++)
+            level.at(i) = std::max(level.at(i), level.at(fanin_edges.at(j).port) + 1);
+        num_levels = std::max(num_levels, level.at(i) + 1);
+    }
+    // Bucket ports by level, keeping topological order within each level
+    level_offsets.assign(num_levels + 1, 0);
+    for (int i = 0; i < n; i++)
+        level_offsets.at(level.at(i) + 1)++;
+    for (int l = 0; l < num_levels; l++)
+        level_offsets.at(l + 1) += level_offsets.at(l);
+    level_ports.resize(n);
+    std::vector<int> fill(level_offsets.begin(), level_offsets.end() - 1);
+    for (int i = 0; i < n; i++)
+        level_ports.at(fill.at(level.at(i))++) = i;
+}
+
+std::vector<int> TimingAnalyser::get_cone(const std::vector<int> &seeds, bool forward, std::vector<bool> &in_cone,
+                                          size_t max_size)
+{
+    std::vector<int> cone, queue;
+    auto visit = [&](int p) {
+        if (in_cone.at(p))
+            return;
+        in_cone.at(p) = true;
+        cone.push_back(p);
+        queue.push_back(p);
+    };
+    for (int seed : seeds)
+        visit(seed);
+    const auto &offsets = forward ? fanout_offsets : fanin_offsets;
+    const auto &edges = forward ? fanout_edges : fanin_edges;
+    while (!queue.empty() && cone.size() <= max_size) {
+        int p = queue.back();
+        queue.pop_back();
+        for (int i = offsets.at(p); i < offsets.at(p + 1); i++)
+            visit(edges.at(i).port);
+    }
+    std::sort(cone.begin(), cone.end());
+    return cone;
+}
+
+bool TimingAnalyser::run_incremental()
+{
+    // If most of the design is affected, a full run is cheaper than working out the cones
+    size_t max_cone = ports.size() / 2;
+    // Arrival times change downstream of a changed route delay; required times upstream of the net driver
+    std::vector<int> bwd_seeds;
+    for (int p : dirty_ports)
+        for (int i = fanin_offsets.at(p); i < fanin_offsets.at(p + 1); i++)
+            if (fanin_edges.at(i).is_route)
+                bwd_seeds.push_back(fanin_edges.at(i).port);
+    std::vector<bool> in_fwd(ports.size(), false), in_bwd(ports.size(), false);
+    std::vector<int> fwd_cone = get_cone(dirty_ports, true, in_fwd, max_cone);
+    if (fwd_cone.size() > max_cone)
+        return false;
+    std::vector<int> bwd_cone = get_cone(bwd_seeds, false, in_bwd, max_cone);
+    if (bwd_cone.size() > max_cone)
+        return false;
+
+    auto reset_time = [&](ArrivReqTime &t) {
+        t.value = init_delay;
+        t.path_length = 0;
+        t.bwd_min = -1;
+        t.bwd_max = -1;
+    };
+
+    // Forward: recompute arrival times of the cone from scratch. Fanin outside the cone is up to date, and fanin inside
+    // the cone comes earlier in topological order
+    for (int p : fwd_cone)
+        for (int a = arrival.begin(p); a < arrival.end(p); a++)
+            reset_time(arrival.value.at(a));
+    for (domain_id_t dom_id = 0; dom_id < domain_id_t(domains.size()); ++dom_id)
+        for (auto &sp : domains.at(dom_id).startpoints)
+            if (in_fwd.at(sp.first))
+                init_startpoint(dom_id, sp);
+    for (int p : fwd_cone)
+        pull_arrival(p);
+
+    // Backward: likewise for required times
+    for (int p : bwd_cone)
+        for (int r = required.begin(p); r < required.end(p); r++)
+            reset_time(required.value.at(r));
+    for (domain_id_t dom_id = 0; dom_id < domain_id_t(domains.size()); ++dom_id)
+        for (auto &ep : domains.at(dom_id).endpoints)
+            if (in_bwd.at(ep.first))
+                init_endpoint(dom_id, ep);
+    for (int p : reversed_range(bwd_cone))
+        pull_required(p);
+
+    // Slack only changes for ports in either cone; but the worst slack of a domain pair might come from anywhere
+    std::vector<int> changed;
+    std::set_union(fwd_cone.begin(), fwd_cone.end(), bwd_cone.begin(), bwd_cone.end(), std::back_inserter(changed));
+    for (int p : changed)
+        compute_port_slack(p);
+    std::vector<std::pair<delay_t, delay_t>> old_worst;
+    for (auto &dp : domain_pairs)
+        old_worst.emplace_back(dp.worst_setup_slack, dp.worst_hold_slack);
+    update_domain_pair_slack();
+    bool worst_changed = false;
+    for (size_t i = 0; i < domain_pairs.size(); i++)
+        if (domain_pairs.at(i).worst_setup_slack != old_worst.at(i).first)
+            worst_changed = true;
+    if (worst_changed) {
+        compute_criticality();
+    } else {
+        for (int p : changed)
+            compute_port_criticality(p);
+    }
+
+    clear_dirty();
+    return true;
+}
+
+void TimingAnalyser::check_incremental_results()
+{
+    std::vector<PerPort> incr_ports = ports;
+    std::vector<ArrivReqTime> incr_arrival = arrival.value, incr_required = required.value;
+    std::vector<PortDomainPairData> incr_pairs = port_domain_pairs.value;
+    std::vector<PerDomainPair> incr_domain_pairs = domain_pairs;
+    run_full();
+    auto mismatch = [&](int p, const char *what) {
+        auto &key = ports.at(p).cell_port;
+        log_error("Incremental timing analysis mismatch at %s.%s: %s\n", ctx->nameOf(key.cell), ctx->nameOf(key.port),
+                  what);
+    };
+    auto same_time = [](const ArrivReqTime &a, const ArrivReqTime &b) {
+        return a.value.min_delay == b.value.min_delay && a.value.max_delay == b.value.max_delay &&
+               a.path_length == b.path_length;
+    };
+    for (int p = 0; p < int(ports.size()); p++) {
+        for (int a = arrival.begin(p); a < arrival.end(p); a++)
+            if (!same_time(arrival.value.at(a), incr_arrival.at(a)))
+                mismatch(p, "arrival time");
+        for (int r = required.begin(p); r < required.end(p); r++)
+            if (!same_time(required.value.at(r), incr_required.at(r)))
+                mismatch(p, "required time");
+        for (int i = port_domain_pairs.begin(p); i < port_domain_pairs.end(p); i++) {
+            auto &full = port_domain_pairs.value.at(i), &incr = incr_pairs.at(i);
+            if (full.setup_slack != incr.setup_slack || full.hold_slack != incr.hold_slack)
+                mismatch(p, "slack");
+            if (full.criticality != incr.criticality)
+                mismatch(p, "criticality");
         }
+        auto &full = ports.at(p), &incr = incr_ports.at(p);
+        if (full.worst_crit != incr.worst_crit || full.worst_setup_slack != incr.worst_setup_slack ||
+            full.worst_hold_slack != incr.worst_hold_slack)
+            mismatch(p, "worst slack/criticality");
     }
+    for (size_t i = 0; i < domain_pairs.size(); i++)
+        if (domain_pairs.at(i).worst_setup_slack != incr_domain_pairs.at(i).worst_setup_slack ||
+            domain_pairs.at(i).worst_hold_slack != incr_domain_pairs.at(i).worst_hold_slack)
+            log_error("Incremental timing analysis mismatch in worst slack of domain pair %d\n", int(i));
 }
 
 void TimingAnalyser::print_fmax()
 {
     // Temporary testing code for comparison only
     dict<int, double> domain_fmax;
-    for (auto p : topological_order) {
-        auto &pd = ports.at(p);
-        for (auto &req : pd.required) {
-            if (pd.arrival.count(req.first)) {
-                auto &arr = pd.arrival.at(req.first);
-                double fmax = 1000.0 / ctx->getDelayNS(arr.value.maxDelay() - req.second.value.minDelay());
-                if (!domain_fmax.count(req.first) || domain_fmax.at(req.first) > fmax)
-                    domain_fmax[req.first] = fmax;
+    for (int p = 0; p < int(ports.size()); p++) {
+        for (int r = required.begin(p); r < required.end(p); r++) {
+            domain_id_t dom = required.domain.at(r);
+            int a = arrival.find(p, dom);
+            if (a != -1) {
+                auto &arr = arrival.value.at(a);
+                double fmax = 1000.0 / ctx->getDelayNS(arr.value.maxDelay() - required.value.at(r).value.minDelay());
+                if (!domain_fmax.count(dom) || domain_fmax.at(dom) > fmax)
+                    domain_fmax[dom] = fmax;
             }
         }
     }
@@ -617,81 +947,102 @@ void TimingAnalyser::print_fmax()
     }
 }
 
-void TimingAnalyser::compute_slack()
+void TimingAnalyser::compute_port_slack(int p)
+{
+    auto &pd = ports.at(p);
+    pd.worst_setup_slack = std::numeric_limits<delay_t>::max();
+    pd.worst_hold_slack = std::numeric_limits<delay_t>::max();
+    for (int i = port_domain_pairs.begin(p); i < port_domain_pairs.end(p); i++) {
+        auto &pdp = port_domain_pairs.value.at(i);
+        auto &dp = domain_pairs.at(port_domain_pairs.domain.at(i));
+
+        // Get clock names
+        const auto &launch_clock = domains.at(dp.key.launch).key.clock;
+        const auto &capture_clock = domains.at(dp.key.capture).key.clock;
+
+        // Get clock-to-clock delay if any
+        delay_t clock_to_clock = 0;
+        auto clocks = std::make_pair(launch_clock, capture_clock);
+        if (clock_delays.count(clocks)) {
+            clock_to_clock = clock_delays.at(clocks);
+        }
+
+        auto &arr = arrival.value.at(arrival.find(p, dp.key.launch));
+        auto &req = required.value.at(required.find(p, dp.key.capture));
+        pdp.setup_slack = 0 - (arr.value.maxDelay() - req.value.minDelay() + clock_to_clock);
+        if (!setup_only)
+            pdp.hold_slack = arr.value.minDelay() - req.value.maxDelay() + clock_to_clock;
+        pdp.max_path_length = arr.path_length + req.path_length;
+        if (dp.key.launch == dp.key.capture)
+            pd.worst_setup_slack = std::min(pd.worst_setup_slack, dp.period.minDelay() + pdp.setup_slack);
+        if (!setup_only)
+            pd.worst_hold_slack = std::min(pd.worst_hold_slack, pdp.hold_slack);
+    }
+}
+
+void TimingAnalyser::update_domain_pair_slack()
 {
     for (auto &dp : domain_pairs) {
         dp.worst_setup_slack = std::numeric_limits<delay_t>::max();
         dp.worst_hold_slack = std::numeric_limits<delay_t>::max();
     }
-    for (auto p : topological_order) {
-        auto &pd = ports.at(p);
-        for (auto &pdp : pd.domain_pairs) {
-            auto &dp = domain_pairs.at(pdp.first);
-
-            // Get clock names
-            const auto &launch_clock = domains.at(dp.key.launch).key.clock;
-            const auto &capture_clock = domains.at(dp.key.capture).key.clock;
-
-            // Get clock-to-clock delay if any
-            delay_t clock_to_clock = 0;
-            auto clocks = std::make_pair(launch_clock, capture_clock);
-            if (clock_delays.count(clocks)) {
-                clock_to_clock = clock_delays.at(clocks);
-            }
+    for (size_t i = 0; i < port_domain_pairs.value.size(); i++) {
+        auto &pdp = port_domain_pairs.value[i];
+        auto &dp = domain_pairs.at(port_domain_pairs.domain[i]);
+        dp.worst_setup_slack = std::min(dp.worst_setup_slack, pdp.setup_slack);
+        if (!setup_only)
+            dp.worst_hold_slack = std::min(dp.worst_hold_slack, pdp.hold_slack);
+    }
+}
 
-            auto &arr = pd.arrival.at(dp.key.launch);
-            auto &req = pd.required.at(dp.key.capture);
-            pdp.second.setup_slack = 0 - (arr.value.maxDelay() - req.value.minDelay() + clock_to_clock);
-            if (!setup_only)
-                pdp.second.hold_slack = arr.value.minDelay() - req.value.maxDelay() + clock_to_clock;
-            pdp.second.max_path_length = arr.path_length + req.path_length;
-            if (dp.key.launch == dp.key.capture)
-                pd.worst_setup_slack = std::min(pd.worst_setup_slack, dp.period.minDelay() + pdp.second.setup_slack);
-            dp.worst_setup_slack = std::min(dp.worst_setup_slack, pdp.second.setup_slack);
-            if (!setup_only) {
-                pd.worst_hold_slack = std::min(pd.worst_hold_slack, pdp.second.hold_slack);
-                dp.worst_hold_slack = std::min(dp.worst_hold_slack, pdp.second.hold_slack);
-            }
-        }
+void TimingAnalyser::compute_slack()
+{
+    for (int p = 0; p < int(ports.size()); p++)
+        compute_port_slack(p);
+    update_domain_pair_slack();
+}
+
+void TimingAnalyser::compute_port_criticality(int p)
+{
+    auto &pd = ports.at(p);
+    pd.worst_crit = 0;
+    for (int i = port_domain_pairs.begin(p); i < port_domain_pairs.end(p); i++) {
+        auto &pdp = port_domain_pairs.value.at(i);
+        auto &dp = domain_pairs.at(port_domain_pairs.domain.at(i));
+        float crit = 1.0f - (float(pdp.setup_slack) - float(dp.worst_setup_slack)) / float(-dp.worst_setup_slack);
+        crit = std::min(crit, 1.0f);
+        crit = std::max(crit, 0.0f);
+        pdp.criticality = crit;
+        pd.worst_crit = std::max(pd.worst_crit, crit);
     }
 }
 
 void TimingAnalyser::compute_criticality()
 {
-    for (auto p : topological_order) {
-        auto &pd = ports.at(p);
-        for (auto &pdp : pd.domain_pairs) {
-            auto &dp = domain_pairs.at(pdp.first);
-            float crit =
-                    1.0f - (float(pdp.second.setup_slack) - float(dp.worst_setup_slack)) / float(-dp.worst_setup_slack);
-            crit = std::min(crit, 1.0f);
-            crit = std::max(crit, 0.0f);
-            pdp.second.criticality = crit;
-            pd.worst_crit = std::max(pd.worst_crit, crit);
-        }
-    }
+    for (int p = 0; p < int(ports.size()); p++)
+        compute_port_criticality(p);
 }
 
-std::vector<CellPortKey> TimingAnalyser::get_failing_eps(domain_id_t domain_pair, int count)
+std::vector<int> TimingAnalyser::get_failing_eps(domain_id_t domain_pair, int count)
 {
-    std::vector<CellPortKey> failing_eps;
+    std::vector<int> failing_eps;
     delay_t last_slack = std::numeric_limits<delay_t>::min();
     auto &dp = domain_pairs.at(domain_pair);
     auto &cap_d = domains.at(dp.key.capture);
     while (int(failing_eps.size()) < count) {
-        CellPortKey next;
+        int next = -1;
         delay_t next_slack = std::numeric_limits<delay_t>::max();
         for (auto ep : cap_d.endpoints) {
-            auto &pd = ports.at(ep.first);
-            if (!pd.domain_pairs.count(domain_pair))
+            int idx = port_domain_pairs.find(ep.first, domain_pair);
+            if (idx == -1)
                 continue;
-            delay_t ep_slack = pd.domain_pairs.at(domain_pair).setup_slack;
+            delay_t ep_slack = port_domain_pairs.value.at(idx).setup_slack;
             if (ep_slack < next_slack && ep_slack > last_slack) {
                 next = ep.first;
                 next_slack = ep_slack;
             }
         }
-        if (next == CellPortKey())
+        if (next == -1)
             break;
         failing_eps.push_back(next);
         last_slack = next_slack;
@@ -699,18 +1050,21 @@ std::vector<CellPortKey> TimingAnalyser::get_failing_eps(domain_id_t domain_pair
     return failing_eps;
 }
 
-void TimingAnalyser::print_critical_path(CellPortKey endpoint, domain_id_t domain_pair)
+void TimingAnalyser::print_critical_path(int endpoint, domain_id_t domain_pair)
 {
-    CellPortKey cursor = endpoint;
+    int cursor = endpoint;
     auto &dp = domain_pairs.at(domain_pair);
-    log("    endpoint %s.%s (slack %.02fns):\n", ctx->nameOf(cursor.cell), ctx->nameOf(cursor.port),
-        ctx->getDelayNS(ports.at(cursor).domain_pairs.at(domain_pair).setup_slack));
-    while (cursor != CellPortKey()) {
-        log("        %s.%s (net %s)\n", ctx->nameOf(cursor.cell), ctx->nameOf(cursor.port),
-            ctx->nameOf(ctx->cells.at(cursor.cell)->getPort(cursor.port)));
-        if (!ports.at(cursor).arrival.count(dp.key.launch))
+    auto &ep_key = ports.at(endpoint).cell_port;
+    log("    endpoint %s.%s (slack %.02fns):\n", ctx->nameOf(ep_key.cell), ctx->nameOf(ep_key.port),
+        ctx->getDelayNS(port_domain_pairs.value.at(port_domain_pairs.find(endpoint, domain_pair)).setup_slack));
+    while (cursor != -1) {
+        auto &key = ports.at(cursor).cell_port;
+        log("        %s.%s (net %s)\n", ctx->nameOf(key.cell), ctx->nameOf(key.port),
+            ctx->nameOf(ctx->cells.at(key.cell)->getPort(key.port)));
+        int a = arrival.find(cursor, dp.key.launch);
+        if (a == -1)
             break;
-        cursor = ports.at(cursor).arrival.at(dp.key.launch).bwd_max;
+        cursor = arrival.value.at(a).bwd_max;
     }
 }
 
@@ -760,14 +1114,6 @@ domain_id_t TimingAnalyser::domain_pair_id(domain_id_t launch, domain_id_t captu
     return inserted.first->second;
 }
 
-void TimingAnalyser::copy_domains(const CellPortKey &from, const CellPortKey &to, bool backward)
-{
-    auto &f = ports.at(from), &t = ports.at(to);
-    for (auto &dom : (backward ? f.required : f.arrival)) {
-        updated_domains |= (backward ? t.required : t.arrival).emplace(dom.first, ArrivReqTime{}).second;
-    }
-}
-
 CellInfo *TimingAnalyser::cell_info(const CellPortKey &key) { return ctx->cells.at(key.cell).get(); }
 
 PortInfo &TimingAnalyser::port_info(const CellPortKey &key) { return ctx->cells.at(key.cell)->ports.at(key.port); }
@@ -24,6 +24,8 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
+struct WorkerPool;
+
 struct CellPortKey
 {
     CellPortKey(){};
@@ -73,7 +75,8 @@ struct ClockDomainPairKey
 struct TimingAnalyser
 {
   public:
-    TimingAnalyser(Context *ctx) : ctx(ctx){};
+    TimingAnalyser(Context *ctx);
+    ~TimingAnalyser();
     void setup();
     void run(bool update_route_delays = true);
     void print_report();
@@ -82,13 +85,14 @@ struct TimingAnalyser
     // model), but want to re-run STA with their own calculated delays
     void set_route_delay(CellPortKey port, DelayPair value);
 
-    float get_criticality(CellPortKey port) const { return ports.at(port).worst_crit; }
-    float get_setup_slack(CellPortKey port) const { return ports.at(port).worst_setup_slack; }
+    float get_criticality(CellPortKey port) const { return ports.at(port_to_id.at(port)).worst_crit; }
+    float get_setup_slack(CellPortKey port) const { return ports.at(port_to_id.at(port)).worst_setup_slack; }
     float get_domain_setup_slack(CellPortKey port) const
     {
         delay_t slack = std::numeric_limits<delay_t>::max();
-        for (const auto &dp : ports.at(port).domain_pairs)
-            slack = std::min(slack, domain_pairs.at(dp.first).worst_setup_slack);
+        int id = port_to_id.at(port);
+        for (int i = port_domain_pairs.begin(id); i < port_domain_pairs.end(id); i++)
+            slack = std::min(slack, domain_pairs.at(port_domain_pairs.domain.at(i)).worst_setup_slack);
         return slack;
     }
 
@@ -99,44 +103,79 @@ struct TimingAnalyser
     bool have_loops = false;
     bool updated_domains = false;
 
+    // Only re-propagate the cones of ports whose route delay changed since the last run ("timing/incremental")
+    bool incremental = true;
+    // Check every incremental run against a full recompute, for debugging ("timing/checkIncremental")
+    bool check_incremental = false;
+    // Worker threads for the levelised arrival/required time walks ("threads")
+    int threads = 1;
+
   private:
     void init_ports();
     void get_cell_delays();
     void get_route_delays();
     void topo_sort();
+    void build_graph();
     void setup_port_domains();
     void identify_related_domains();
 
     void reset_times();
 
+    void run_full();
+    // Returns false if too much of the design is affected to be worth doing incrementally
+    bool run_incremental();
+    void check_incremental_results();
+    void clear_dirty();
+
     void walk_forward();
     void walk_backward();
 
+    // Level of each port, for the levelised walks
+    void build_levels();
+    // Run func on the id of each port, level by level, with the ports in a level split between threads
+    template <typename Tfunc> void for_each_level(bool backward, Tfunc func);
+    // Created on the first walk large enough to be split, then kept for every later walk
+    std::unique_ptr<WorkerPool> workers;
+
+    // Calls func(target, is_route, cell_delay) for each timing arc out of a port, using the netlist
+    template <typename Tfunc> void for_each_fanout(int port, Tfunc func);
+    // Ports reachable from the seeds, as sorted port ids. Stops early once larger than max_size
+    std::vector<int> get_cone(const std::vector<int> &seeds, bool forward, std::vector<bool> &in_cone,
+                              size_t max_size);
+
     void compute_slack();
+    void update_domain_pair_slack();
     void compute_criticality();
 
     void print_fmax();
     // get the N most failing endpoints for a given domain pair
-    std::vector<CellPortKey> get_failing_eps(domain_id_t domain_pair, int count);
+    std::vector<int> get_failing_eps(domain_id_t domain_pair, int count);
     // print the critical path for an endpoint and domain pair
-    void print_critical_path(CellPortKey endpoint, domain_id_t domain_pair);
+    void print_critical_path(int endpoint, domain_id_t domain_pair);
 
     const DelayPair init_delay{std::numeric_limits<delay_t>::max(), std::numeric_limits<delay_t>::lowest()};
 
+    void init_startpoint(domain_id_t dom_id, const std::pair<int, int> &sp);
+    void init_endpoint(domain_id_t dom_id, const std::pair<int, int> &ep);
+    // Push a port's arrival/required times to its fanout/fanin
+    void propagate_arrival(int p);
+    void propagate_required(int p);
+    // Gather a port's arrival/required times from its fanin/fanout, so that ports in a level can be done in parallel
+    void pull_arrival(int p);
+    void pull_required(int p);
+
     // Set arrival/required times if more/less than the current value
-    void set_arrival_time(CellPortKey target, domain_id_t domain, DelayPair arrival, int path_length,
-                          CellPortKey prev = CellPortKey());
-    void set_required_time(CellPortKey target, domain_id_t domain, DelayPair required, int path_length,
-                           CellPortKey prev = CellPortKey());
+    void set_arrival_time(int target, domain_id_t domain, DelayPair arrival_time, int path_length, int prev = -1);
+    void set_required_time(int target, domain_id_t domain, DelayPair required_time, int path_length, int prev = -1);
 
     // To avoid storing the domain tag structure (which could get large when considering more complex constrained tag
     // cases), assign each domain an ID and use that instead
-    // An arrival or required time entry. Stores both the min/max delays; and the traversal to reach them for critical
-    // path reporting
+    // An arrival or required time entry. Stores both the min/max delays; and the traversal (as port ids) to reach them
+    // for critical path reporting
     struct ArrivReqTime
     {
         DelayPair value;
-        CellPortKey bwd_min, bwd_max;
+        int bwd_min = -1, bwd_max = -1;
         int path_length;
     };
     // Data per port-domain tuple
@@ -171,15 +210,11 @@ struct TimingAnalyser
                 : type(type), other_port(other_port), value(value), edge(edge){};
     };
 
-    // Timing data for every cell port
+    // Timing data for every cell port, indexed by port id. Port ids follow the topological order
     struct PerPort
     {
         CellPortKey cell_port;
         PortType type;
-        // per domain timings
-        dict<domain_id_t, ArrivReqTime> arrival;
-        dict<domain_id_t, ArrivReqTime> required;
-        dict<domain_id_t, PortDomainPairData> domain_pairs;
         // cell timing arcs to (outputs)/from (inputs)  from this port
         std::vector<CellArc> cell_arcs;
         // routing delay into this port (input ports only)
@@ -188,14 +223,59 @@ struct TimingAnalyser
         float worst_crit = 0;
         delay_t worst_setup_slack = std::numeric_limits<delay_t>::max(),
                 worst_hold_slack = std::numeric_limits<delay_t>::max();
+        // route_delay changed since the last run
+        bool route_dirty = false;
+    };
+
+    // An arc of the timing graph, from the point of view of one of its ports: either routing from an output port to a
+    // user of its net (the delay is the route_delay of the user), or combinational through a cell
+    struct TimingEdge
+    {
+        int port;
+        bool is_route;
+        DelayPair cell_delay;
     };
 
+    // Values per port and domain (or domain pair), flattened. The entries for port p are [begin(p), end(p)), sorted by
+    // domain
+    template <typename T> struct PortDomainTable
+    {
+        std::vector<int> offsets;
+        std::vector<domain_id_t> domain;
+        std::vector<T> value;
+
+        int begin(int port) const { return offsets.at(port); }
+        int end(int port) const { return offsets.at(port + 1); }
+        // Index of the entry for a port and domain, or -1 if there is none
+        int find(int port, domain_id_t dom) const
+        {
+            for (int i = begin(port); i < end(port); i++)
+                if (domain.at(i) == dom)
+                    return i;
+            return -1;
+        }
+        void build(const std::vector<std::vector<domain_id_t>> &port_domains)
+        {
+            offsets.assign(1, 0);
+            domain.clear();
+            for (auto &doms : port_domains) {
+                domain.insert(domain.end(), doms.begin(), doms.end());
+                std::sort(domain.end() - doms.size(), domain.end());
+                offsets.push_back(int(domain.size()));
+            }
+            value.assign(domain.size(), T());
+        }
+    };
+
+    void compute_port_slack(int p);
+    void compute_port_criticality(int p);
+
     struct PerDomain
     {
         PerDomain(ClockDomainKey key) : key(key){};
         ClockDomainKey key;
-        // these are pairs (signal port; clock port)
-        std::vector<std::pair<CellPortKey, IdString>> startpoints, endpoints;
+        // these are pairs (signal port; clock port) of port ids
+        std::vector<std::pair<int, int>> startpoints, endpoints;
     };
 
     struct PerDomainPair
@@ -213,16 +293,27 @@ struct TimingAnalyser
     domain_id_t domain_id(const NetInfo *net, ClockEdge edge);
     domain_id_t domain_pair_id(domain_id_t launch, domain_id_t capture);
 
-    void copy_domains(const CellPortKey &from, const CellPortKey &to, bool backwards);
-
-    dict<CellPortKey, PerPort> ports;
+    std::vector<PerPort> ports;
+    dict<CellPortKey, int> port_to_id;
     dict<ClockDomainKey, domain_id_t> domain_to_id;
     dict<ClockDomainPairKey, domain_id_t> pair_to_id;
     std::vector<PerDomain> domains;
     std::vector<PerDomainPair> domain_pairs;
     dict<std::pair<IdString, IdString>, delay_t> clock_delays;
 
-    std::vector<CellPortKey> topological_order;
+    // Fanin and fanout of each port in CSR form; the edges of port p are edges[offsets[p]..offsets[p+1]), sorted by the
+    // id of the other port
+    std::vector<int> fanin_offsets, fanout_offsets;
+    std::vector<TimingEdge> fanin_edges, fanout_edges;
+    // Ports grouped by level; level l is level_ports[level_offsets[l]..[l+1])
+    std::vector<int> level_ports, level_offsets;
+
+    PortDomainTable<ArrivReqTime> arrival, required;
+    PortDomainTable<PortDomainPairData> port_domain_pairs;
+
+    std::vector<int> dirty_ports;
+    // Arrival and required times are consistent with the route delays of all non-dirty ports
+    bool times_valid = false;
 
     Context *ctx;
 };
@@ -0,0 +1,126 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#ifndef NPNR_DISABLE_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Long-lived set of workers, so that passes that fork and join many times don't pay for thread creation each time.
+// Job index 0 runs on the calling thread.
+struct WorkerPool
+{
+#ifndef NPNR_DISABLE_THREADS
+    explicit WorkerPool(int count) : count(count)
+    {
+        for (int i = 1; i < count; i++)
+            workers.emplace_back([this, i]() { worker_loop(i); });
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            shutdown = true;
+            ++generation;
+        }
+        start_cv.notify_all();
+        for (auto &w : workers)
+            w.join();
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    int size() const { return count; }
+
+    // Run func(i) for every i in [0, size()) and wait for all of them to finish
+    void run(std::function<void(int)> func)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            job = std::move(func);
+            pending = count - 1;
+            ++generation;
+        }
+        start_cv.notify_all();
+        job(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [&]() { return pending == 0; });
+    }
+
+  private:
+    void worker_loop(int idx)
+    {
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start_cv.wait(lock, [&]() { return generation != seen; });
+                seen = generation;
+                if (shutdown)
+                    return;
+            }
+            job(idx);
+            std::unique_lock<std::mutex> lock(mutex);
+            if (--pending == 0)
+                done_cv.notify_one();
+        }
+    }
+
+    int count;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start_cv, done_cv;
+    std::function<void(int)> job;
+    uint64_t generation = 0;
+    int pending = 0;
+    bool shutdown = false;
+#else
+    // Without threads the jobs are simply run one after another on the calling thread
+    explicit WorkerPool(int count) : count(count) {}
+
+    int size() const { return count; }
+
+    void run(std::function<void(int)> func)
+    {
+        for (int i = 0; i < count; i++)
+            func(i);
+    }
+
+  private:
+    int count;
+#endif
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif /* WORKER_POOL_H */
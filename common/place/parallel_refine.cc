@@ -24,8 +24,11 @@
 
 #include "detail_place_core.h"
 #include "scope_lock.h"
+#include "worker_pool.h"
 
 #include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <queue>
 #include <shared_mutex>
@@ -304,8 +307,8 @@ struct ThreadState : DetailPlacerThreadState
             int x = t.first, y = t.second;
             int lx = std::max(x - g.radius, p.x0), rx = std::min(x + g.radius, p.x1);
             int by = std::max(y - g.radius, p.y0), ty = std::min(y + g.radius, p.y1);
-            int xn = lx + ctx->rng((rx - lx) + 1);
-            int yn = by + ctx->rng((ty - by) + 1);
+            int xn = lx + rng.rng((rx - lx) + 1);
+            int yn = by + rng.rng((ty - by) + 1);
             ++n_move;
             if (do_tile_swap(x, y, xn, yn)) {
                 ++n_accept;
@@ -352,6 +355,7 @@ struct ParallelRefine
     Context *ctx;
     GlobalState g;
     std::vector<ThreadState> t;
+    std::unique_ptr<WorkerPool> workers;
     ParallelRefine(Context *ctx, ParallelRefineCfg cfg) : ctx(ctx), g(ctx, cfg)
     {
         g.flat_nets.reserve(ctx->nets.size());
@@ -363,6 +367,7 @@ struct ParallelRefine
         for (int i = 0; i < cfg.threads; i++) {
             t.emplace_back(ctx, g, i);
         }
+        workers.reset(new WorkerPool(cfg.threads));
         // Setup region bounds
         for (auto &region : ctx->region) {
             Region *r = region.second.get();
@@ -403,31 +408,32 @@ struct ParallelRefine
         }
     };
     std::vector<PlacePartition> parts;
-    void do_partition()
+    // Recursively bisect a partition into count parts, alternating axes. Each side of a split receives a share
+    // of the cells proportional to the number of parts it will be divided into, so any thread count is balanced.
+    void split_partition(PlacePartition &part, int count, bool yaxis)
     {
-        parts.clear();
-        parts.emplace_back(ctx);
-        bool yaxis = false;
-        while (parts.size() < t.size()) {
-            std::vector<PlacePartition> next(parts.size() * 2);
-            for (size_t i = 0; i < parts.size(); i++) {
-                // Randomly permute pivot every iteration so we get different thread boundaries
-                const float delta = 0.1;
-                float pivot = (0.5 - (delta / 2)) + (delta / 2) * (ctx->rng(10000) / 10000.0f);
-                parts.at(i).split(ctx, yaxis, pivot, next.at(i * 2), next.at(i * 2 + 1));
-            }
-            std::swap(parts, next);
-            yaxis = !yaxis;
+        if (count == 1) {
+            parts.push_back(std::move(part));
+            return;
         }
+        int count_l = count / 2;
+        // Randomly permute pivot every iteration so we get different thread boundaries
+        const float delta = 0.1;
+        float frac = float(count_l) / count;
+        float pivot = (frac - (delta / 2)) + (delta / 2) * (ctx->rng(10000) / 10000.0f);
+        PlacePartition l, r;
+        part.split(ctx, yaxis, pivot, l, r);
+        split_partition(l, count_l, !yaxis);
+        split_partition(r, count - count_l, !yaxis);
+    }
 
+    void do_partition()
+    {
+        parts.clear();
+        PlacePartition root(ctx);
+        split_partition(root, int(t.size()), false);
         NPNR_ASSERT(parts.size() == t.size());
-        // TODO: thread pool to make this worthwhile...
-        std::vector<std::thread> workers;
-        for (size_t i = 0; i < t.size(); i++) {
-            workers.emplace_back([i, this]() { t.at(i).set_partition(parts.at(i)); });
-        }
-        for (auto &w : workers)
-            w.join();
+        workers->run([this](int i) { t.at(i).set_partition(parts.at(i)); });
     }
 
     void run()
@@ -439,6 +445,10 @@ struct ParallelRefine
         g.tmg.setup_only = true;
         g.tmg.setup();
         do_partition();
+        // Time spent in partitioning and thread setup, move evaluation and global cost update; this iteration
+        // and in total
+        double part_time = 0, move_time = 0, update_time = 0;
+        double total_part_time = 0, total_move_time = 0, total_update_time = 0;
         log_info("Running parallel refinement with %d threads.\n", int(t.size()));
         int iter = 1;
         bool done = false;
@@ -471,29 +481,39 @@ struct ParallelRefine
                     --g.radius;
             }
 
-            if ((iter == 1) || ((iter % 5) == 0) || done)
+            if ((iter == 1) || ((iter % 5) == 0) || done) {
                 log_info("  at iteration #%d: temp = %f, timing cost = "
                          "%.0f, wirelen = %.0f\n",
                          iter, g.temperature, double(g.total_timing_cost), double(g.total_wirelen));
+                if (iter > 1)
+                    log_info("    partition %.02fs, moves %.02fs, update %.02fs\n", part_time, move_time,
+                             update_time);
+            }
 
             if (done)
                 break;
 
+            auto part_start = std::chrono::high_resolution_clock::now();
             do_partition();
-
-            std::vector<std::thread> workers;
-            workers.reserve(t.size());
-            for (int j = 0; j < int(t.size()); j++)
-                workers.emplace_back([this, j]() { t.at(j).run_iter(); });
-            for (auto &w : workers)
-                w.join();
+            auto move_start = std::chrono::high_resolution_clock::now();
+            workers->run([this](int i) { t.at(i).run_iter(); });
+            auto update_start = std::chrono::high_resolution_clock::now();
             g.tmg.run();
             g.update_global_costs();
+            auto update_end = std::chrono::high_resolution_clock::now();
+            part_time = std::chrono::duration<double>(move_start - part_start).count();
+            move_time = std::chrono::duration<double>(update_start - move_start).count();
+            update_time = std::chrono::duration<double>(update_end - update_start).count();
+            total_part_time += part_time;
+            total_move_time += move_time;
+            total_update_time += update_time;
             iter++;
             ctx->yield();
         }
         auto refine_end = std::chrono::high_resolution_clock::now();
-        log_info("Placement refine time %.02fs\n", std::chrono::duration<float>(refine_end - refine_start).count());
+        log_info("Placement refine time %.02fs (partition %.02fs, moves %.02fs, update %.02fs)\n",
+                 std::chrono::duration<float>(refine_end - refine_start).count(), total_part_time, total_move_time,
+                 total_update_time);
     }
 };
 } // namespace
@@ -501,11 +521,8 @@ struct ParallelRefine
 ParallelRefineCfg::ParallelRefineCfg(Context *ctx) : DetailPlaceCfg(ctx)
 {
     threads = ctx->setting<int>("threads", 8);
-    // snap to nearest power of two; and minimum thread size
-    int actual_threads = 1;
-    while ((actual_threads * 2) <= threads && (int(ctx->cells.size()) / (actual_threads * 2)) >= min_thread_size)
-        actual_threads *= 2;
-    threads = actual_threads;
+    // limit so every thread gets at least the minimum number of cells
+    threads = std::max(1, std::min(threads, int(ctx->cells.size()) / min_thread_size));
 }
 
 bool parallel_refine(Context *ctx, ParallelRefineCfg cfg)
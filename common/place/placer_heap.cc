@@ -34,6 +34,7 @@
 #include "placer_heap.h"
 #include <Eigen/Core>
 #include <Eigen/IterativeLinearSolvers>
+#include <atomic>
 #include <boost/optional.hpp>
 #include <chrono>
 #include <deque>
@@ -50,6 +51,7 @@
 #include "scope_lock.h"
 #include "timing.h"
 #include "util.h"
+#include "worker_pool.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
@@ -60,40 +62,33 @@ namespace {
 template <typename T> struct EquationSystem
 {
 
-    EquationSystem(size_t rows, size_t cols)
+    EquationSystem() {}
+    EquationSystem(size_t rows, size_t cols) { resize(rows, cols); }
+
+    // Coefficients are gathered as (row, col, x[row, col]) triplets and summed into the compressed matrix when solving
+    std::vector<Eigen::Triplet<T>> coeffs;
+    std::vector<T> rhs; // RHS vector
+    // Use an incomplete Cholesky rather than a Jacobi preconditioner
+    bool use_ic = false;
+    // Number of solves and total conjugate gradient iterations, for logging
+    int solves = 0, iterations = 0;
+
+    void resize(size_t rows, size_t cols)
     {
-        A.resize(cols);
+        if (size_t(mat.rows()) == rows && size_t(mat.cols()) == cols)
+            return;
+        mat.resize(rows, cols);
         rhs.resize(rows);
+        pattern.clear();
     }
 
-    // Simple sparse format, easy to convert to CCS for solver
-    std::vector<std::vector<std::pair<int, T>>> A; // col -> (row, x[row, col]) sorted by row
-    std::vector<T> rhs;                            // RHS vector
     void reset()
     {
-        for (auto &col : A)
-            col.clear();
+        coeffs.clear();
         std::fill(rhs.begin(), rhs.end(), T());
     }
 
-    void add_coeff(int row, int col, T val)
-    {
-        auto &Ac = A.at(col);
-        // Binary search
-        int b = 0, e = int(Ac.size()) - 1;
-        while (b <= e) {
-            int i = (b + e) / 2;
-            if (Ac.at(i).first == row) {
-                Ac.at(i).second += val;
-                return;
-            }
-            if (Ac.at(i).first > row)
-                e = i - 1;
-            else
-                b = i + 1;
-        }
-        Ac.insert(Ac.begin() + b, std::make_pair(row, val));
-    }
+    void add_coeff(int row, int col, T val) { coeffs.emplace_back(row, col, val); }
 
     void add_rhs(int row, T val) { rhs[row] += val; }
 
@@ -102,33 +97,71 @@ template <typename T> struct EquationSystem
         using namespace Eigen;
         if (x.empty())
             return;
-        NPNR_ASSERT(x.size() == A.size());
+        NPNR_ASSERT(x.size() == size_t(mat.cols()));
 
-        VectorXd vx(x.size()), vb(rhs.size());
-        SparseMatrix<T> mat(A.size(), A.size());
-
-        std::vector<int> colnnz;
-        for (auto &Ac : A)
-            colnnz.push_back(int(Ac.size()));
-        mat.reserve(colnnz);
-        for (int col = 0; col < int(A.size()); col++) {
-            auto &Ac = A.at(col);
-            for (auto &el : Ac)
-                mat.insert(el.first, col) = el.second;
-        }
+        compress();
 
+        VectorXd vx(x.size()), vb(rhs.size());
         for (int i = 0; i < int(x.size()); i++)
             vx[i] = x.at(i);
         for (int i = 0; i < int(rhs.size()); i++)
             vb[i] = rhs.at(i);
 
-        ConjugateGradient<SparseMatrix<T>, Lower | Upper> solver;
-        solver.setTolerance(tolerance);
-        VectorXd xr = solver.compute(mat).solveWithGuess(vb, vx);
+        VectorXd xr;
+        if (use_ic) {
+            ic_solver.setTolerance(tolerance);
+            if (!analysed)
+                ic_solver.analyzePattern(mat);
+            ic_solver.factorize(mat);
+            xr = ic_solver.solveWithGuess(vb, vx);
+            iterations += int(ic_solver.iterations());
+        } else {
+            jacobi_solver.setTolerance(tolerance);
+            xr = jacobi_solver.compute(mat).solveWithGuess(vb, vx);
+            iterations += int(jacobi_solver.iterations());
+        }
+        analysed = true;
+        ++solves;
         for (int i = 0; i < int(x.size()); i++)
             x.at(i) = xr[i];
-        // for (int i = 0; i < int(x.size()); i++)
-        //    log_info("x[%d] = %f\n", i, x.at(i));
+    }
+
+  private:
+    Eigen::SparseMatrix<T> mat;
+    // (row, col) of each triplet at the last compress, and the index of its entry in the compressed values
+    std::vector<std::pair<int, int>> pattern;
+    std::vector<int> coeff_slot;
+    bool analysed = false;
+    Eigen::ConjugateGradient<Eigen::SparseMatrix<T>, Eigen::Lower | Eigen::Upper, Eigen::DiagonalPreconditioner<T>>
+            jacobi_solver;
+    Eigen::ConjugateGradient<Eigen::SparseMatrix<T>, Eigen::Lower | Eigen::Upper, Eigen::IncompleteCholesky<T>>
+            ic_solver;
+
+    // Build the compressed matrix from the triplets. If they are the same entries in the same order as last time
+    // (which is usual between the solves of one placer iteration), only the values are updated and the structure and
+    // preconditioner ordering are kept
+    void compress()
+    {
+        bool same_pattern = (pattern.size() == coeffs.size());
+        for (size_t i = 0; same_pattern && i < coeffs.size(); i++)
+            same_pattern = (pattern[i].first == coeffs[i].row() && pattern[i].second == coeffs[i].col());
+        if (same_pattern) {
+            std::fill(mat.valuePtr(), mat.valuePtr() + mat.nonZeros(), T());
+            for (size_t i = 0; i < coeffs.size(); i++)
+                mat.valuePtr()[coeff_slot[i]] += coeffs[i].value();
+            return;
+        }
+        mat.setFromTriplets(coeffs.begin(), coeffs.end());
+        pattern.resize(coeffs.size());
+        coeff_slot.resize(coeffs.size());
+        for (size_t i = 0; i < coeffs.size(); i++) {
+            int row = coeffs[i].row(), col = coeffs[i].col();
+            pattern[i] = std::make_pair(row, col);
+            const int *begin = mat.innerIndexPtr() + mat.outerIndexPtr()[col];
+            const int *end = mat.innerIndexPtr() + mat.outerIndexPtr()[col + 1];
+            coeff_slot[i] = int(std::lower_bound(begin, end, row) - mat.innerIndexPtr());
+        }
+        analysed = false;
     }
 };
 
@@ -158,6 +191,9 @@ class HeAPPlacer
         build_fast_bels();
         seed_placement();
         update_all_chains();
+        setup_equation_pins();
+        for (auto &es : equations)
+            es.use_ic = cfg.solverIC;
         wirelen_t hpwl = total_hpwl();
         log_info("Creating initial analytic placement for %d cells, random placement wirelen = %d.\n",
                  int(place_cells.size()), int(hpwl));
@@ -225,6 +261,7 @@ class HeAPPlacer
             // Alternate between particular bel types and all bels
             for (auto &run : heap_runs) {
                 auto run_startt = std::chrono::high_resolution_clock::now();
+                int run_cg_iters = equations[0].iterations + equations[1].iterations;
 
                 setup_solve_cells(&run);
                 if (solve_cells.empty())
@@ -251,14 +288,16 @@ class HeAPPlacer
 
                 update_all_chains();
 
-                // Run the spreader
+                // Run the spreader; each spreader only moves cells of its own buckets, so they are independent
+                std::vector<CutSpreader> spreaders;
                 for (const auto &group : cfg.cellGroups)
-                    CutSpreader(this, group).run();
+                    spreaders.emplace_back(this, group);
 
                 for (auto type : run)
                     if (std::all_of(cfg.cellGroups.begin(), cfg.cellGroups.end(),
                                     [type](const pool<BelBucketId> &grp) { return !grp.count(type); }))
-                        CutSpreader(this, {type}).run();
+                        spreaders.emplace_back(this, pool<BelBucketId>{type});
+                run_spreaders(spreaders);
 
                 // Run strict legalisation to find a valid bel for all cells
                 update_all_chains();
@@ -270,15 +309,21 @@ class HeAPPlacer
                 auto run_stopt = std::chrono::high_resolution_clock::now();
 
                 IdString bucket_name = ctx->getBelBucketName(*run.begin());
-                log_info("    at iteration #%d, type %s: wirelen solved = %d, spread = %d, legal = %d; time = %.02fs\n",
+                run_cg_iters = equations[0].iterations + equations[1].iterations - run_cg_iters;
+                log_info("    at iteration #%d, type %s: wirelen solved = %d, spread = %d, legal = %d; "
+                         "solver iters = %d; time = %.02fs\n",
                          iter + 1, (run.size() > 1 ? "ALL" : bucket_name.c_str(ctx)), int(solved_hpwl),
-                         int(spread_hpwl), int(legal_hpwl),
+                         int(spread_hpwl), int(legal_hpwl), run_cg_iters,
                          std::chrono::duration<double>(run_stopt - run_startt).count());
             }
 
             // Update timing weights
-            if (cfg.timing_driven)
+            if (cfg.timing_driven) {
+                auto tmg_startt = std::chrono::high_resolution_clock::now();
                 tmg.run();
+                auto tmg_endt = std::chrono::high_resolution_clock::now();
+                tmg_time += std::chrono::duration<double>(tmg_endt - tmg_startt).count();
+            }
 
             if (legal_hpwl < best_hpwl) {
                 best_hpwl = legal_hpwl;
@@ -346,9 +391,15 @@ class HeAPPlacer
 
         auto endtt = std::chrono::high_resolution_clock::now();
         log_info("HeAP Placer Time: %.02fs\n", std::chrono::duration<double>(endtt - startt).count());
-        log_info("  of which solving equations: %.02fs\n", solve_time);
-        log_info("  of which spreading cells: %.02fs\n", cl_time);
+        int solves = equations[0].solves + equations[1].solves;
+        int cg_iters = equations[0].iterations + equations[1].iterations;
+        log_info("  of which solving equations: %.02fs (%d solves, %.1f %s-preconditioned CG iterations per solve)\n",
+                 solve_time, solves, solves > 0 ? double(cg_iters) / solves : 0.0, cfg.solverIC ? "IC" : "Jacobi");
+        log_info("  of which spreading cells: %.02fs (%.02fs of work across up to %d threads)\n", cl_time, cl_work_time,
+                 spread_threads);
         log_info("  of which strict legalisation: %.02fs\n", sl_time);
+        if (cfg.timing_driven)
+            log_info("  of which timing analysis: %.02fs\n", tmg_time);
 
         ctx->check();
         lock.unlock_early();
@@ -403,10 +454,28 @@ class HeAPPlacer
     // cells of a certain type)
     std::vector<CellInfo *> solve_cells;
 
+    // The nets considered when building equations, with their pins flattened into arrays and cells given a dense
+    // index, so that positions can be looked up by index rather than name
+    struct EquationNet
+    {
+        NetInfo *ni;
+        int pin_begin, pin_end;
+    };
+    std::vector<EquationNet> eqn_nets;
+    std::vector<CellInfo *> eqn_cells;
+    std::vector<int> pin_cell;
+    std::vector<PortRef *> pin_port;
+    std::vector<bool> pin_is_user;
+    // The x and y equation systems, kept between solves to reuse their storage and matrix structure
+    EquationSystem<double> equations[2];
+
     dict<ClusterId, std::vector<CellInfo *>> cluster2cells;
     dict<ClusterId, int> chain_size;
     // Performance counting
-    double solve_time = 0, cl_time = 0, sl_time = 0;
+    double solve_time = 0, cl_time = 0, sl_time = 0, tmg_time = 0;
+    // Sum of the time taken by each spreader, which exceeds cl_time when they run in parallel
+    double cl_work_time = 0;
+    int spread_threads = 1;
 
     // Place cells with the BEL attribute set to constrain them
     void place_constraints()
@@ -510,10 +579,12 @@ class HeAPPlacer
     // Build and solve in one direction
     void build_solve_direction(bool yaxis, int iter)
     {
+        auto &es = equations[yaxis ? 1 : 0];
+        es.resize(solve_cells.size(), solve_cells.size());
         for (int i = 0; i < 5; i++) {
-            EquationSystem<double> esx(solve_cells.size(), solve_cells.size());
-            build_equations(esx, yaxis, iter);
-            solve_equations(esx, yaxis);
+            build_equations(es, yaxis, iter);
+            // After the first solve, start from the previous unrounded solution
+            solve_equations(es, yaxis, i > 0);
         }
     }
 
@@ -688,10 +759,46 @@ class HeAPPlacer
             func(usr.value, usr.index);
     }
 
+    // Flatten the pins of the nets that take part in the equations
+    void setup_equation_pins()
+    {
+        dict<IdString, int> cell_index;
+        eqn_nets.clear();
+        eqn_cells.clear();
+        pin_cell.clear();
+        pin_port.clear();
+        pin_is_user.clear();
+        for (auto &net : ctx->nets) {
+            NetInfo *ni = net.second.get();
+            if (ni->driver.cell == nullptr)
+                continue;
+            if (ni->users.empty())
+                continue;
+            if (cell_locs.at(ni->driver.cell->name).global)
+                continue;
+            EquationNet en{ni, int(pin_cell.size()), 0};
+            foreach_port(ni, [&](PortRef &port, store_index<PortRef> user_idx) {
+                auto inserted = cell_index.emplace(port.cell->name, int(eqn_cells.size()));
+                if (inserted.second)
+                    eqn_cells.push_back(port.cell);
+                pin_cell.push_back(inserted.first->second);
+                pin_port.push_back(&port);
+                pin_is_user.push_back(bool(user_idx));
+            });
+            en.pin_end = int(pin_cell.size());
+            eqn_nets.push_back(en);
+        }
+    }
+
     // Build the system of equations for either X or Y
     void build_equations(EquationSystem<double> &es, bool yaxis, int iter = -1)
     {
-        // Return the x or y position of a cell, depending on ydir
+        // The x or y position of each cell, depending on ydir
+        std::vector<int> pos(eqn_cells.size());
+        for (size_t i = 0; i < eqn_cells.size(); i++) {
+            auto &loc = cell_locs.at(eqn_cells.at(i)->name);
+            pos.at(i) = yaxis ? loc.y : loc.x;
+        }
         auto cell_pos = [&](CellInfo *cell) { return yaxis ? cell_locs.at(cell->name).y : cell_locs.at(cell->name).x; };
         auto legal_pos = [&](CellInfo *cell) {
             return yaxis ? cell_locs.at(cell->name).legal_y : cell_locs.at(cell->name).legal_x;
@@ -699,73 +806,68 @@ class HeAPPlacer
 
         es.reset();
 
-        for (auto &net : ctx->nets) {
-            NetInfo *ni = net.second.get();
-            if (ni->driver.cell == nullptr)
-                continue;
-            if (ni->users.empty())
-                continue;
-            if (cell_locs.at(ni->driver.cell->name).global)
-                continue;
-            // Find the bounds of the net in this axis, and the ports that correspond to these bounds
-            PortRef *lbport = nullptr, *ubport = nullptr;
+        for (auto &net : eqn_nets) {
+            NetInfo *ni = net.ni;
+            // Find the bounds of the net in this axis, and the pins that correspond to these bounds
+            int lbpin = -1, ubpin = -1;
             int lbpos = std::numeric_limits<int>::max(), ubpos = std::numeric_limits<int>::min();
-            foreach_port(ni, [&](PortRef &port, store_index<PortRef> user_idx) {
-                int pos = cell_pos(port.cell);
-                if (pos < lbpos) {
-                    lbpos = pos;
-                    lbport = &port;
+            for (int pin = net.pin_begin; pin < net.pin_end; pin++) {
+                int p = pos[pin_cell[pin]];
+                if (p < lbpos) {
+                    lbpos = p;
+                    lbpin = pin;
                 }
-                if (pos > ubpos) {
-                    ubpos = pos;
-                    ubport = &port;
+                if (p > ubpos) {
+                    ubpos = p;
+                    ubpin = pin;
                 }
-            });
-            NPNR_ASSERT(lbport != nullptr);
-            NPNR_ASSERT(ubport != nullptr);
+            }
+            NPNR_ASSERT(lbpin != -1);
+            NPNR_ASSERT(ubpin != -1);
 
-            auto stamp_equation = [&](PortRef &var, PortRef &eqn, double weight) {
-                if (eqn.cell->udata == dont_solve)
+            auto stamp_equation = [&](int var, int eqn, double weight) {
+                CellInfo *eqn_cell = eqn_cells[pin_cell[eqn]];
+                if (eqn_cell->udata == dont_solve)
                     return;
-                int row = eqn.cell->udata;
-                int v_pos = cell_pos(var.cell);
-                if (var.cell->udata != dont_solve) {
-                    es.add_coeff(row, var.cell->udata, weight);
+                int row = eqn_cell->udata;
+                CellInfo *var_cell = eqn_cells[pin_cell[var]];
+                if (var_cell->udata != dont_solve) {
+                    es.add_coeff(row, var_cell->udata, weight);
                 } else {
-                    es.add_rhs(row, -v_pos * weight);
+                    es.add_rhs(row, -pos[pin_cell[var]] * weight);
                 }
-                if (var.cell->cluster != ClusterId()) {
-                    Loc offset = ctx->getClusterOffset(var.cell);
+                if (var_cell->cluster != ClusterId()) {
+                    Loc offset = ctx->getClusterOffset(var_cell);
                     es.add_rhs(row, -(yaxis ? offset.y : offset.x) * weight);
                 }
             };
 
             // Add all relevant connections to the matrix
-            foreach_port(ni, [&](PortRef &port, store_index<PortRef> user_idx) {
-                int this_pos = cell_pos(port.cell);
-                auto process_arc = [&](PortRef *other) {
-                    if (other == &port)
+            for (int pin = net.pin_begin; pin < net.pin_end; pin++) {
+                int this_pos = pos[pin_cell[pin]];
+                double tmg_weight = 1.0;
+                if (pin_is_user[pin])
+                    tmg_weight += cfg.timingWeight *
+                                  std::pow(tmg.get_criticality(CellPortKey(*pin_port[pin])), cfg.criticalityExponent);
+                auto process_arc = [&](int other) {
+                    if (other == pin)
                         return;
-                    int o_pos = cell_pos(other->cell);
+                    int o_pos = pos[pin_cell[other]];
                     double weight = 1.0 / (ni->users.entries() *
                                            std::max<double>(1, (yaxis ? cfg.hpwl_scale_y : cfg.hpwl_scale_x) *
                                                                        std::abs(o_pos - this_pos)));
-
-                    if (user_idx) {
-                        weight *= (1.0 + cfg.timingWeight * std::pow(tmg.get_criticality(CellPortKey(port)),
-                                                                     cfg.criticalityExponent));
-                    }
+                    weight *= tmg_weight;
 
                     // If cell 0 is not fixed, it will stamp +w on its equation and -w on the other end's equation,
                     // if the other end isn't fixed
-                    stamp_equation(port, port, weight);
-                    stamp_equation(port, *other, -weight);
-                    stamp_equation(*other, *other, weight);
-                    stamp_equation(*other, port, -weight);
+                    stamp_equation(pin, pin, weight);
+                    stamp_equation(pin, other, -weight);
+                    stamp_equation(other, other, weight);
+                    stamp_equation(other, pin, -weight);
                 };
-                process_arc(lbport);
-                process_arc(ubport);
-            });
+                process_arc(lbpin);
+                process_arc(ubpin);
+            }
         }
         if (iter != -1) {
             float alpha = cfg.alpha;
@@ -783,28 +885,34 @@ class HeAPPlacer
         }
     }
 
-    // Build the system of equations for either X or Y
-    void solve_equations(EquationSystem<double> &es, bool yaxis)
+    // Solve the system of equations for either X or Y, starting from the current positions or, if warm_start, from the
+    // unrounded result of the previous solve
+    void solve_equations(EquationSystem<double> &es, bool yaxis, bool warm_start)
     {
-        // Return the x or y position of a cell, depending on ydir
-        auto cell_pos = [&](CellInfo *cell) { return yaxis ? cell_locs.at(cell->name).y : cell_locs.at(cell->name).x; };
         std::vector<double> vals;
-        std::transform(solve_cells.begin(), solve_cells.end(), std::back_inserter(vals), cell_pos);
+        for (auto cell : solve_cells) {
+            auto &loc = cell_locs.at(cell->name);
+            if (warm_start)
+                vals.push_back(yaxis ? loc.rawy : loc.rawx);
+            else
+                vals.push_back(yaxis ? loc.y : loc.x);
+        }
         es.solve(vals, cfg.solverTolerance);
-        for (size_t i = 0; i < vals.size(); i++)
+        for (size_t i = 0; i < vals.size(); i++) {
+            CellInfo *cell = solve_cells.at(i);
+            auto &loc = cell_locs.at(cell->name);
             if (yaxis) {
-                cell_locs.at(solve_cells.at(i)->name).rawy = vals.at(i);
-                cell_locs.at(solve_cells.at(i)->name).y = std::min(max_y, std::max(0, int(vals.at(i))));
-                if (solve_cells.at(i)->region != nullptr)
-                    cell_locs.at(solve_cells.at(i)->name).y =
-                            limit_to_reg(solve_cells.at(i)->region, cell_locs.at(solve_cells.at(i)->name).y, true);
+                loc.rawy = vals.at(i);
+                loc.y = std::min(max_y, std::max(0, int(vals.at(i))));
+                if (cell->region != nullptr)
+                    loc.y = limit_to_reg(cell->region, loc.y, true);
             } else {
-                cell_locs.at(solve_cells.at(i)->name).rawx = vals.at(i);
-                cell_locs.at(solve_cells.at(i)->name).x = std::min(max_x, std::max(0, int(vals.at(i))));
-                if (solve_cells.at(i)->region != nullptr)
-                    cell_locs.at(solve_cells.at(i)->name).x =
-                            limit_to_reg(solve_cells.at(i)->region, cell_locs.at(solve_cells.at(i)->name).x, false);
+                loc.rawx = vals.at(i);
+                loc.x = std::min(max_x, std::max(0, int(vals.at(i))));
+                if (cell->region != nullptr)
+                    loc.x = limit_to_reg(cell->region, loc.x, false);
             }
+        }
     }
 
     // Compute HPWL
@@ -1104,8 +1212,10 @@ class HeAPPlacer
     {
         if (reg == nullptr)
             return val;
-        int limit_low = dir ? constraint_region_bounds[reg->name].y0 : constraint_region_bounds[reg->name].x0;
-        int limit_high = dir ? constraint_region_bounds[reg->name].y1 : constraint_region_bounds[reg->name].x1;
+        // Called from multiple spreader threads, so must not insert into constraint_region_bounds
+        const BoundingBox &bounds = constraint_region_bounds.at(reg->name);
+        int limit_low = dir ? bounds.y0 : bounds.x0;
+        int limit_high = dir ? bounds.y1 : bounds.x1;
         return std::max<T>(std::min<T>(val, limit_high), limit_low);
     }
 
@@ -1151,79 +1261,46 @@ class HeAPPlacer
             }
         }
         static int seq;
-        void run()
+
+        // A region still to be cut, and the direction to try cutting it in first
+        struct CutTask
+        {
+            SpreaderRegion r;
+            bool dir;
+        };
+
+        // Find the overused regions and grow them until they fit, returning them as the first regions to cut
+        std::vector<CutTask> prepare()
         {
-            auto startt = std::chrono::high_resolution_clock::now();
             init();
             find_overused_regions();
-            for (auto &r : regions) {
-                if (merged_regions.count(r.id))
-                    continue;
-#if 0
-                log_info("%s (%d, %d) |_> (%d, %d) %d/%d\n", beltype.c_str(ctx), r.x0, r.y0, r.x1, r.y1, r.cells,
-                         r.bels);
-#endif
-            }
             expand_regions();
-            std::queue<std::pair<int, bool>> workqueue;
-#if 0
-            std::vector<std::pair<double, double>> orig;
-            if (ctx->debug)
-                for (auto c : p->solve_cells)
-                    orig.emplace_back(p->cell_locs[c->name].rawx, p->cell_locs[c->name].rawy);
-#endif
-            for (auto &r : regions) {
-                if (merged_regions.count(r.id))
-                    continue;
-#if 0
-                for (auto t : sorted(beltype)) {
-                    log_info("%s (%d, %d) |_> (%d, %d) %d/%d\n", t.c_str(ctx), r.x0, r.y0, r.x1, r.y1,
-                             r.cells.at(type_index.at(t)), r.bels.at(type_index.at(t)));
-                }
+            std::vector<CutTask> tasks;
+            for (auto &r : regions)
+                if (!merged_regions.count(r.id))
+                    tasks.push_back(CutTask{r, false});
+            return tasks;
+        }
 
-#endif
-                workqueue.emplace(r.id, false);
-            }
-            while (!workqueue.empty()) {
-                auto front = workqueue.front();
-                workqueue.pop();
-                auto &r = regions.at(front.first);
-                if (std::all_of(r.cells.begin(), r.cells.end(), [](int x) { return x == 0; }))
-                    continue;
-                auto res = cut_region(r, front.second);
-                if (res) {
-                    workqueue.emplace(res->first, !front.second);
-                    workqueue.emplace(res->second, !front.second);
-                } else {
-                    // Try the other dir, in case stuck in one direction only
-                    auto res2 = cut_region(r, !front.second);
-                    if (res2) {
-                        workqueue.emplace(res2->first, front.second);
-                        workqueue.emplace(res2->second, front.second);
-                    }
-                }
-            }
-#if 0
-            if (ctx->debug) {
-                std::ofstream sp("spread" + std::to_string(seq) + ".csv");
-                for (size_t i = 0; i < p->solve_cells.size(); i++) {
-                    auto &c = p->solve_cells.at(i);
-                    if (c->type != beltype)
-                        continue;
-                    sp << orig.at(i).first << "," << orig.at(i).second << "," << p->cell_locs[c->name].rawx << "," << p->cell_locs[c->name].rawy << std::endl;
-                }
-                std::ofstream oc("cells" + std::to_string(seq) + ".csv");
-                for (size_t y = 0; y <= p->max_y; y++) {
-                    for (size_t x = 0; x <= p->max_x; x++) {
-                        oc << cells_at_location.at(x).at(y).size() << ", ";
-                    }
-                    oc << std::endl;
+        // Cut a region in two (in the other direction if the first fails), adding the halves to out for cutting next.
+        // Only the cells inside the region and their entries in cells_at_location are touched, so regions that don't
+        // overlap can be cut concurrently.
+        void cut(const CutTask &task, std::vector<CutTask> &out)
+        {
+            if (std::all_of(task.r.cells.begin(), task.r.cells.end(), [](int x) { return x == 0; }))
+                return;
+            auto res = cut_region(task.r, task.dir);
+            if (res) {
+                out.push_back(CutTask{res->first, !task.dir});
+                out.push_back(CutTask{res->second, !task.dir});
+            } else {
+                // Try the other dir, in case stuck in one direction only
+                auto res2 = cut_region(task.r, !task.dir);
+                if (res2) {
+                    out.push_back(CutTask{res2->first, task.dir});
+                    out.push_back(CutTask{res2->second, task.dir});
                 }
-                ++seq;
             }
-#endif
-            auto endt = std::chrono::high_resolution_clock::now();
-            p->cl_time += std::chrono::duration<float>(endt - startt).count();
         }
 
       private:
@@ -1537,11 +1614,9 @@ class HeAPPlacer
         // Implementation of the recursive cut-based spreading as described in the HeAP paper
         // Note we use "left" to mean "-x/-y" depending on dir and "right" to mean "+x/+y" depending on dir
 
-        std::vector<CellInfo *> cut_cells;
-
-        boost::optional<std::pair<int, int>> cut_region(SpreaderRegion &r, bool dir)
+        boost::optional<std::pair<SpreaderRegion, SpreaderRegion>> cut_region(const SpreaderRegion &r, bool dir)
         {
-            cut_cells.clear();
+            std::vector<CellInfo *> cut_cells;
             auto &cal = cells_at_location;
             int total_cells = 0, total_bels = 0;
             for (int x = r.x0; x <= r.x1; x++) {
@@ -1778,32 +1853,85 @@ class HeAPPlacer
                 cl.y = std::min(r.y1, std::max(r.y0, int(cl.rawy)));
                 cells_at_location.at(cl.x).at(cl.y).push_back(cell);
             }
+            // The halves aren't added to regions or groups, which are only needed to find and merge overused regions
             SpreaderRegion rl, rr;
-            rl.id = int(regions.size());
+            rl.id = -1;
             rl.x0 = r.x0;
             rl.y0 = r.y0;
             rl.x1 = dir ? r.x1 : best_tgt_cut;
             rl.y1 = dir ? best_tgt_cut : r.y1;
             rl.cells = left_cells_v;
             rl.bels = left_bels_v;
-            rr.id = int(regions.size()) + 1;
+            rr.id = -1;
             rr.x0 = dir ? r.x0 : (best_tgt_cut + 1);
             rr.y0 = dir ? (best_tgt_cut + 1) : r.y0;
             rr.x1 = r.x1;
             rr.y1 = r.y1;
             rr.cells = right_cells_v;
             rr.bels = right_bels_v;
-            regions.push_back(rl);
-            regions.push_back(rr);
-            for (int x = rl.x0; x <= rl.x1; x++)
-                for (int y = rl.y0; y <= rl.y1; y++)
-                    groups.at(x).at(y) = rl.id;
-            for (int x = rr.x0; x <= rr.x1; x++)
-                for (int y = rr.y0; y <= rr.y1; y++)
-                    groups.at(x).at(y) = rr.id;
-            return std::make_pair(rl.id, rr.id);
+            return std::make_pair(rl, rr);
         };
     };
+    // Kept across iterations, so spreading doesn't start new threads each time
+    std::unique_ptr<WorkerPool> workers;
+
+    // Run spreaders for disjoint sets of buckets. Spreaders are prepared in parallel, then all their regions are cut
+    // level by level: the halves of a cut don't overlap each other or any other region, so a whole level of cuts
+    // (across all spreaders) can be done at once. The result doesn't depend on the number of threads.
+    void run_spreaders(std::vector<CutSpreader> &spreaders)
+    {
+        auto startt = std::chrono::high_resolution_clock::now();
+        int n_threads = 1;
+#ifndef NPNR_DISABLE_THREADS
+        n_threads = std::max(1, cfg.threads);
+#endif
+        if (n_threads > 1 && !workers)
+            workers.reset(new WorkerPool(n_threads));
+        std::vector<double> busy(n_threads, 0);
+        // Runs func(i) for every i in [0, count), shared out between the workers
+        auto for_each_index = [&](size_t count, const std::function<void(size_t)> &func) {
+            if (n_threads == 1 || count < 2) {
+                auto job_start = std::chrono::high_resolution_clock::now();
+                for (size_t i = 0; i < count; i++)
+                    func(i);
+                auto job_end = std::chrono::high_resolution_clock::now();
+                busy.at(0) += std::chrono::duration<double>(job_end - job_start).count();
+                return;
+            }
+            std::atomic<size_t> next{0};
+            workers->run([&](int tid) {
+                auto job_start = std::chrono::high_resolution_clock::now();
+                for (size_t i = next++; i < count; i = next++)
+                    func(i);
+                auto job_end = std::chrono::high_resolution_clock::now();
+                busy.at(tid) += std::chrono::duration<double>(job_end - job_start).count();
+            });
+            spread_threads = std::max(spread_threads, int(std::min(size_t(n_threads), count)));
+        };
+
+        std::vector<std::vector<CutSpreader::CutTask>> tasks(spreaders.size());
+        for_each_index(spreaders.size(), [&](size_t i) { tasks.at(i) = spreaders.at(i).prepare(); });
+        std::vector<std::pair<CutSpreader *, CutSpreader::CutTask>> level, next_level;
+        for (size_t i = 0; i < spreaders.size(); i++)
+            for (auto &task : tasks.at(i))
+                level.emplace_back(&spreaders.at(i), std::move(task));
+        std::vector<std::vector<CutSpreader::CutTask>> halves;
+        while (!level.empty()) {
+            halves.clear();
+            halves.resize(level.size());
+            for_each_index(level.size(), [&](size_t i) { level.at(i).first->cut(level.at(i).second, halves.at(i)); });
+            next_level.clear();
+            for (size_t i = 0; i < level.size(); i++)
+                for (auto &half : halves.at(i))
+                    next_level.emplace_back(level.at(i).first, std::move(half));
+            std::swap(level, next_level);
+        }
+
+        auto endt = std::chrono::high_resolution_clock::now();
+        cl_time += std::chrono::duration<double>(endt - startt).count();
+        cl_work_time += std::accumulate(busy.begin(), busy.end(), 0.0);
+    }
+
     typedef decltype(CellInfo::udata) cell_udata_t;
     cell_udata_t dont_solve = std::numeric_limits<cell_udata_t>::max();
 };
@@ -1819,9 +1947,11 @@ PlacerHeapCfg::PlacerHeapCfg(Context *ctx)
     timingWeight = ctx->setting<int>("placerHeap/timingWeight");
     parallelRefine = ctx->setting<bool>("placerHeap/parallelRefine", false);
     netShareWeight = ctx->setting<float>("placerHeap/netShareWeight", 0);
+    threads = ctx->setting<int>("threads", 8);
 
     timing_driven = ctx->setting<bool>("timing_driven");
     solverTolerance = 1e-5;
+    solverIC = ctx->setting<bool>("placerHeap/solverIC", false);
     placeAllAtOnce = false;
 
     int timeout_divisor = ctx->setting<int>("placerHeap/cellPlacementTimeout", 8);
@@ -40,10 +40,14 @@ struct PlacerHeapCfg
     float timingWeight;
     bool timing_driven;
     float solverTolerance;
+    // Use an incomplete Cholesky rather than a Jacobi preconditioner for the conjugate gradient solver
+    bool solverIC;
     bool placeAllAtOnce;
     float netShareWeight;
     bool parallelRefine;
     int cell_placement_timeout;
+    // Maximum number of bucket groups to spread in parallel
+    int threads;
 
     int hpwl_scale_x, hpwl_scale_y;
     int spread_scale_x, spread_scale_y;
@@ -0,0 +1,117 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "route_queue.h"
+#include <chrono>
+#include <queue>
+#include "deterministic_rng.h"
+#include "log.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+// Laid out like the router2 queue entries
+struct BenchEntry
+{
+    int wire;
+    float cost, togo_cost;
+    int randtag;
+
+    struct Greater
+    {
+        bool operator()(const BenchEntry &lhs, const BenchEntry &rhs) const noexcept
+        {
+            float lhs_score = lhs.cost + lhs.togo_cost, rhs_score = rhs.cost + rhs.togo_cost;
+            return lhs_score == rhs_score ? lhs.randtag > rhs.randtag : lhs_score > rhs_score;
+        }
+    };
+};
+
+// Route a number of synthetic arcs: each pop expands a few children with a higher cost and a noisy estimate, and the
+// queue is cleared between arcs like in the routers. Returns a checksum of the pop order
+template <typename Tqueue, typename Tclear>
+uint64_t run_workload(Tqueue &queue, Tclear clear, int arcs, int pops_per_arc, uint64_t &pops)
+{
+    DeterministicRNG rng;
+    uint64_t checksum = 0;
+    for (int arc = 0; arc < arcs; arc++) {
+        clear(queue);
+        for (int i = 0; i < 4; i++)
+            queue.push(BenchEntry{i, 0, float(rng.rng(1000)), i});
+        for (int i = 0; i < pops_per_arc && !queue.empty(); i++) {
+            BenchEntry curr = queue.top();
+            queue.pop();
+            ++pops;
+            // Entries that compare equal may pop in either order for arities other than 2, so only the keys are checked
+            checksum = checksum * 31 + uint32_t(curr.randtag) + uint64_t(curr.cost + curr.togo_cost);
+            int children = rng.rng(7);
+            for (int c = 0; c < children; c++)
+                queue.push(BenchEntry{curr.wire * 7 + c, curr.cost + 1.0f + rng.rng(100) / 50.0f,
+                                      std::max(0.0f, curr.togo_cost - 1.5f + rng.rng(100) / 40.0f), rng.rng()});
+        }
+    }
+    return checksum;
+}
+} // namespace
+
+void route_queue_benchmark()
+{
+    const int reps = 3;
+    // Small arcs (like most local routing) and large ones (like long or congested arcs)
+    const std::vector<std::pair<int, int>> workloads{{200000, 50}, {500, 20000}};
+    for (auto &workload : workloads) {
+        int arcs = workload.first, pops_per_arc = workload.second;
+        log_info("%d arcs of up to %d pops:\n", arcs, pops_per_arc);
+        uint64_t ref_checksum = 0;
+        for (int arity : {0, 2, 4, 8}) {
+            uint64_t checksum = 0, pops = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int r = 0; r < reps; r++) {
+                if (arity == 0) {
+                    // What the routers did before: a std::priority_queue, replaced by a new one to clear it
+                    std::priority_queue<BenchEntry, std::vector<BenchEntry>, BenchEntry::Greater> queue;
+                    checksum = run_workload(
+                            queue,
+                            [](decltype(queue) &q) {
+                                if (!q.empty()) {
+                                    std::priority_queue<BenchEntry, std::vector<BenchEntry>, BenchEntry::Greater> e;
+                                    q.swap(e);
+                                }
+                            },
+                            arcs, pops_per_arc, pops);
+                } else {
+                    RouteQueue<BenchEntry, BenchEntry::Greater> queue(arity);
+                    checksum = run_workload(
+                            queue, [](decltype(queue) &q) { q.clear(); }, arcs, pops_per_arc, pops);
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            double secs = std::chrono::duration<double>(end - start).count();
+            log_info("    %-24s %.02fM pops in %.03fs (%.02f Mpops/s)\n",
+                     (arity == 0) ? "std::priority_queue" : stringf("RouteQueue, arity %d", arity).c_str(),
+                     pops / 1e6, secs, (pops / 1e6) / std::max(secs, 1e-9));
+            if (arity == 0)
+                ref_checksum = checksum;
+            else if (checksum != ref_checksum)
+                log_error("RouteQueue with arity %d popped in a different order to std::priority_queue\n", arity);
+        }
+    }
+}
+
+NEXTPNR_NAMESPACE_END
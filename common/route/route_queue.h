@@ -0,0 +1,124 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef ROUTE_QUEUE_H
+#define ROUTE_QUEUE_H
+
+#include <algorithm>
+#include <vector>
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+/*
+A d-ary min-heap for the router A* searches, ordered like a std::priority_queue<T, std::vector<T>, Greater> (so top()
+is the cheapest entry).
+
+Unlike std::priority_queue, clear() keeps the storage, so a queue that lives as long as the router only allocates while
+growing to the largest search. The arity is chosen at runtime: 4 halves the depth and keeps the children of a node in
+one cache line for small entries, at the cost of more comparisons per level when popping. Arity 2 uses the standard
+library heap algorithms, so entries that compare equal pop in exactly the same order as with std::priority_queue, which
+keeps routing results identical to before, and is the default. Any other arity breaks ties between equal-cost entries
+differently, so opting into 4 with --router-queue-arity changes which of several equally good paths is found and hence
+the routing result.
+
+A*-style routing costs are not monotone (the estimate is weighted and may overestimate), which rules out radix heaps
+without changing the search order.
+*/
+template <typename T, typename Greater> struct RouteQueue
+{
+    explicit RouteQueue(int arity = 2) : arity(arity) { NPNR_ASSERT(arity >= 2); }
+
+    void set_arity(int new_arity)
+    {
+        NPNR_ASSERT(new_arity >= 2);
+        NPNR_ASSERT(heap.empty());
+        arity = new_arity;
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    const T &top() const { return heap.front(); }
+
+    void push(const T &item)
+    {
+        if (arity == 2) {
+            heap.push_back(item);
+            std::push_heap(heap.begin(), heap.end(), greater);
+            return;
+        }
+        size_t i = heap.size();
+        heap.push_back(item);
+        // Sift up, moving parents down into the hole until the item fits
+        while (i > 0) {
+            size_t parent = (i - 1) / arity;
+            if (!greater(heap[parent], item))
+                break;
+            heap[i] = std::move(heap[parent]);
+            i = parent;
+        }
+        heap[i] = item;
+    }
+
+    void pop()
+    {
+        NPNR_ASSERT(!heap.empty());
+        if (arity == 2) {
+            std::pop_heap(heap.begin(), heap.end(), greater);
+            heap.pop_back();
+            return;
+        }
+        T item = std::move(heap.back());
+        heap.pop_back();
+        size_t n = heap.size();
+        if (n == 0)
+            return;
+        // Sift down, moving the cheapest child up into the hole until the item fits
+        size_t i = 0;
+        while (true) {
+            size_t first = i * arity + 1;
+            if (first >= n)
+                break;
+            size_t last = std::min(first + arity, n);
+            size_t best = first;
+            for (size_t c = first + 1; c < last; c++)
+                if (greater(heap[best], heap[c]))
+                    best = c;
+            if (!greater(item, heap[best]))
+                break;
+            heap[i] = std::move(heap[best]);
+            i = best;
+        }
+        heap[i] = std::move(item);
+    }
+
+    void clear() { heap.clear(); }
+
+  private:
+    std::vector<T> heap;
+    size_t arity;
+    Greater greater;
+};
+
+// Compare std::priority_queue against RouteQueue of several arities on a synthetic A*-like workload
+void route_queue_benchmark();
+
+NEXTPNR_NAMESPACE_END
+
+#endif
@@ -22,6 +22,7 @@
 #include <queue>
 
 #include "log.h"
+#include "route_queue.h"
 #include "router1.h"
 #include "scope_lock.h"
 #include "timing.h"
@@ -108,11 +109,56 @@ struct Router1
     dict<arc_key, pool<WireId>> arc_to_wires;
     pool<arc_key> queued_arcs;
 
-    std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> queue;
+    RouteQueue<QueuedWire, QueuedWire::Greater> queue;
 
     dict<WireId, int> wireScores;
     dict<NetInfo *, int, hash_ptr_ops> netScores;
 
+    // A* visited state for the current arc. If the arch provides a dense wire index, this maps it to an entry
+    // of visited_entries (or -1) rather than hashing WireIds.
+    bool use_flat_index = false;
+    dict<WireId, QueuedWire> visited;
+    std::vector<int> flat_visited_slot;
+    std::vector<std::pair<int, QueuedWire>> visited_entries;
+
+    QueuedWire *find_visited(WireId wire)
+    {
+        if (use_flat_index) {
+            int slot = flat_visited_slot.at(ctx->getFlatWireIndex(wire));
+            return (slot == -1) ? nullptr : &visited_entries.at(slot).second;
+        } else {
+            auto fnd = visited.find(wire);
+            return (fnd == visited.end()) ? nullptr : &fnd->second;
+        }
+    }
+
+    void set_visited(const QueuedWire &qw)
+    {
+        if (use_flat_index) {
+            int idx = ctx->getFlatWireIndex(qw.wire);
+            int &slot = flat_visited_slot.at(idx);
+            if (slot == -1) {
+                slot = int(visited_entries.size());
+                visited_entries.emplace_back(idx, qw);
+            } else {
+                visited_entries.at(slot).second = qw;
+            }
+        } else {
+            visited[qw.wire] = qw;
+        }
+    }
+
+    void clear_visited()
+    {
+        if (use_flat_index) {
+            for (auto &entry : visited_entries)
+                flat_visited_slot.at(entry.first) = -1;
+            visited_entries.clear();
+        } else {
+            visited.clear();
+        }
+    }
+
     int arcs_with_ripup = 0;
     int arcs_without_ripup = 0;
     bool ripup_flag;
@@ -121,9 +167,14 @@ struct Router1
 
     bool timing_driven = true;
 
-    Router1(Context *ctx, const Router1Cfg &cfg) : ctx(ctx), cfg(cfg), tmg(ctx)
+    Router1(Context *ctx, const Router1Cfg &cfg) : ctx(ctx), cfg(cfg), queue(cfg.queueArity), tmg(ctx)
     {
         timing_driven = ctx->setting<bool>("timing_driven");
+        int flat_count = ctx->getFlatWireCount();
+        if (flat_count > 0) {
+            use_flat_index = true;
+            flat_visited_slot.resize(flat_count, -1);
+        }
         tmg.setup();
         tmg.run();
     }
@@ -514,11 +565,8 @@ struct Router1
 
         // reset wire queue
 
-        if (!queue.empty()) {
-            std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
-            queue.swap(new_queue);
-        }
-        dict<WireId, QueuedWire> visited;
+        queue.clear();
+        clear_visited();
 
         // A* main loop
 
@@ -541,7 +589,7 @@ struct Router1
             qw.randtag = ctx->rng();
 
             queue.push(qw);
-            visited[qw.wire] = qw;
+            set_visited(qw);
         }
 
         while (visitCnt++ < maxVisitCnt && !queue.empty()) {
@@ -662,10 +710,10 @@ struct Router1
                 if ((best_score >= 0) && (next_score - next_bonus - cfg.estimatePrecision > best_score))
                     continue;
 
-                auto old_visited_it = visited.find(next_wire);
-                if (old_visited_it != visited.end()) {
-                    delay_t old_delay = old_visited_it->second.delay;
-                    delay_t old_score = old_delay + old_visited_it->second.penalty;
+                QueuedWire *old_visited = find_visited(next_wire);
+                if (old_visited != nullptr) {
+                    delay_t old_delay = old_visited->delay;
+                    delay_t old_score = old_delay + old_visited->penalty;
                     NPNR_ASSERT(old_score >= 0);
 
                     if (next_score + ctx->getDelayEpsilon() >= old_score)
@@ -676,7 +724,7 @@ struct Router1
                         log("Found better route to %s. Old vs new delay estimate: %.3f (%.3f) %.3f (%.3f)\n",
                             ctx->nameOfWire(next_wire),
                             ctx->getDelayNS(old_score),
-                            ctx->getDelayNS(old_visited_it->second.delay),
+                            ctx->getDelayNS(old_visited->delay),
                             ctx->getDelayNS(next_score),
                             ctx->getDelayNS(next_delay));
 #endif
@@ -707,7 +755,7 @@ struct Router1
                         ctx->getDelayNS(next_delay));
 #endif
 
-                visited[next_qw.wire] = next_qw;
+                set_visited(next_qw);
                 queue.push(next_qw);
 
                 if (next_wire == dst_wire) {
@@ -720,16 +768,17 @@ struct Router1
         if (ctx->debug)
             log("  total number of visited nodes: %d\n", visitCnt);
 
-        if (visited.count(dst_wire) == 0) {
+        const QueuedWire *dst_visited = find_visited(dst_wire);
+        if (dst_visited == nullptr) {
             if (ctx->debug)
                 log("  no route found for this arc\n");
             return false;
         }
 
         if (ctx->debug) {
-            log("  final route delay:   %8.2f\n", ctx->getDelayNS(visited[dst_wire].delay));
-            log("  final route penalty: %8.2f\n", ctx->getDelayNS(visited[dst_wire].penalty));
-            log("  final route bonus:   %8.2f\n", ctx->getDelayNS(visited[dst_wire].bonus));
+            log("  final route delay:   %8.2f\n", ctx->getDelayNS(dst_visited->delay));
+            log("  final route penalty: %8.2f\n", ctx->getDelayNS(dst_visited->penalty));
+            log("  final route bonus:   %8.2f\n", ctx->getDelayNS(dst_visited->bonus));
             log("  arc budget:      %12.2f\n", ctx->getDelayNS(net_info->users[user_idx].budget));
         }
 
@@ -741,7 +790,7 @@ struct Router1
         delay_t accumulated_path_delay = 0;
         delay_t last_path_delay_delta = 0;
         while (1) {
-            auto pip = visited[cursor].pip;
+            auto pip = find_visited(cursor)->pip;
 
             if (ctx->debug) {
                 delay_t path_delay_delta = ctx->estimateDelay(cursor, dst_wire) - accumulated_path_delay;
@@ -860,6 +909,10 @@ Router1Cfg::Router1Cfg(Context *ctx)
     reuseBonus = wireRipupPenalty / 2;
 
     estimatePrecision = 100 * ctx->getRipupDelayPenalty();
+
+    queueArity = ctx->setting<int>("router/queueArity", 2);
+    if (queueArity < 2)
+        log_error("Router queue arity must be at least 2, got %d\n", queueArity);
 }
 
 bool router1(Context *ctx, const Router1Cfg &cfg)
@@ -36,6 +36,8 @@ struct Router1Cfg
     delay_t netRipupPenalty;
     delay_t reuseBonus;
     delay_t estimatePrecision;
+    // Arity of the A* queue heap
+    int queueArity;
 };
 
 extern bool router1(Context *ctx, const Router1Cfg &cfg);
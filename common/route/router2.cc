@@ -29,15 +29,22 @@
 #include "router2.h"
 
 #include <algorithm>
+#include <atomic>
 #include <boost/container/flat_map.hpp>
 #include <chrono>
+#include <cstdio>
 #include <deque>
 #include <fstream>
+#include <numeric>
 #include <queue>
 #include <set>
+#include <thread>
 
+#include "json11.hpp"
 #include "log.h"
 #include "nextpnr.h"
+#include "perf_counter.h"
+#include "route_queue.h"
 #include "router1.h"
 #include "scope_lock.h"
 #include "timing.h"
@@ -67,6 +74,8 @@ struct Router2
         // Coordinates of the center of the net, used for the weight-to-average
         int cx, cy, hpwl;
         int total_route_us = 0;
+        // Routing time in the current iteration, only kept when tracing
+        int iter_route_us = 0;
         float max_crit = 0;
         int fail_count = 0;
     };
@@ -85,15 +94,21 @@ struct Router2
         // Historical congestion cost
         int curr_cong = 0;
         float hist_cong_cost = 1.0;
-        // Wire is unavailable as locked to another arc
-        bool unavailable = false;
         // This wire has to be used for this net
         int reserved_net = -1;
         // The notional location of the wire, to guarantee thread safety
         int16_t x = 0, y = 0;
-        // Visit data
+        // Wire is unavailable as locked to another arc
+        bool unavailable = false;
+    };
+
+    // Search state, kept in its own array (indexed the same as flat_wires) so the A* loop touches less memory. A
+    // wire is visited in a direction only if its epoch matches the routing thread's current epoch; so unvisiting
+    // all wires at the end of an arc is just a matter of moving on to a new epoch.
+    struct WireVisitData
+    {
+        uint32_t epoch_fwd = 0, epoch_bwd = 0;
         PipId pip_fwd, pip_bwd;
-        bool visited_fwd = false, visited_bwd = false;
     };
 
     Context *ctx;
@@ -180,39 +195,113 @@ struct Router2
         }
     }
 
+    // If the arch provides a dense wire index, use it directly; otherwise fall back to hashing
+    bool use_flat_index = false;
     dict<WireId, int> wire_to_idx;
     std::vector<PerWireData> flat_wires;
+    std::vector<WireVisitData> wire_visit;
+    // Epochs are unique across threads, so stale visit data from one thread can never be mistaken by another
+    std::atomic<uint32_t> next_visit_epoch{1};
+
+    // In incremental mode with a flat index, only wires that are bound at the start are set up eagerly; the rest are
+    // set up when first looked up. Threads routing neighbouring regions can reach the same wire, so each wire has a
+    // state (lazy_unset, lazy_busy, lazy_ready): the thread that claims it sets it up and any other waits until ready.
+    // The per-wire arrays are still sized for the whole device, so this saves setup time rather than memory.
+    bool lazy_wires = false;
+    enum : uint8_t
+    {
+        lazy_unset,
+        lazy_busy,
+        lazy_ready
+    };
+    std::unique_ptr<std::atomic<uint8_t>[]> lazy_state;
+    std::atomic<int> wires_set_up{0};
+
+    int wire_index(WireId w)
+    {
+        if (!use_flat_index)
+            return wire_to_idx.at(w);
+        int idx = ctx->getFlatWireIndex(w);
+        if (lazy_wires && lazy_state[idx].load(std::memory_order_acquire) != lazy_ready)
+            setup_lazy_wire(idx, w);
+        return idx;
+    }
 
-    PerWireData &wire_data(WireId w) { return flat_wires[wire_to_idx.at(w)]; }
+    void setup_lazy_wire(int idx, WireId w)
+    {
+        uint8_t expected = lazy_unset;
+        if (lazy_state[idx].compare_exchange_strong(expected, lazy_busy, std::memory_order_acq_rel)) {
+            // Any wire bound at the start was set up eagerly, so this one only needs its location
+            flat_wires[idx] = make_wire_data(w, /*check_bound=*/false);
+            ++wires_set_up;
+            lazy_state[idx].store(lazy_ready, std::memory_order_release);
+        } else {
+            while (lazy_state[idx].load(std::memory_order_acquire) != lazy_ready)
+                std::this_thread::yield();
+        }
+    }
+    PerWireData &wire_data(WireId w) { return flat_wires[wire_index(w)]; }
+
+    PerWireData make_wire_data(WireId wire, bool check_bound = true)
+    {
+        PerWireData pwd;
+        pwd.w = wire;
+        NetInfo *bound = check_bound ? ctx->getBoundWireNet(wire) : nullptr;
+        if (bound != nullptr) {
+            auto iter = bound->wires.find(wire);
+            if (iter != bound->wires.end()) {
+                auto &nd = nets.at(bound->udata);
+                nd.wires[wire] = std::make_pair(bound->wires.at(wire).pip, 0);
+                pwd.curr_cong = 1;
+                if (bound->wires.at(wire).strength == STRENGTH_PLACER) {
+                    pwd.reserved_net = bound->udata;
+                } else if (bound->wires.at(wire).strength > STRENGTH_PLACER) {
+                    pwd.unavailable = true;
+                }
+            }
+        }
+
+        BoundingBox wire_loc = ctx->getRouteBoundingBox(wire, wire);
+        pwd.x = (wire_loc.x0 + wire_loc.x1) / 2;
+        pwd.y = (wire_loc.y0 + wire_loc.y1) / 2;
+        return pwd;
+    }
 
     void setup_wires()
     {
         // Set up per-wire structures, so that MT parts don't have to do any memory allocation
         // This is possibly quite wasteful and not cache-optimal; further consideration necessary
-        for (auto wire : ctx->getWires()) {
-            PerWireData pwd;
-            pwd.w = wire;
-            NetInfo *bound = ctx->getBoundWireNet(wire);
-            if (bound != nullptr) {
-                auto iter = bound->wires.find(wire);
-                if (iter != bound->wires.end()) {
-                    auto &nd = nets.at(bound->udata);
-                    nd.wires[wire] = std::make_pair(bound->wires.at(wire).pip, 0);
-                    pwd.curr_cong = 1;
-                    if (bound->wires.at(wire).strength == STRENGTH_PLACER) {
-                        pwd.reserved_net = bound->udata;
-                    } else if (bound->wires.at(wire).strength > STRENGTH_PLACER) {
-                        pwd.unavailable = true;
-                    }
+        int flat_count = ctx->getFlatWireCount();
+        use_flat_index = (flat_count > 0);
+        if (use_flat_index) {
+            // Unused entries in the index space are left with w == WireId()
+            flat_wires.resize(flat_count);
+        }
+        if (cfg.incremental && use_flat_index) {
+            lazy_state.reset(new std::atomic<uint8_t>[flat_count]());
+            for (auto net : nets_by_udata)
+                for (auto &wire : net->wires) {
+                    int idx = ctx->getFlatWireIndex(wire.first);
+                    NPNR_ASSERT(idx >= 0 && idx < flat_count);
+                    flat_wires.at(idx) = make_wire_data(wire.first);
+                    lazy_state[idx].store(lazy_ready, std::memory_order_relaxed);
+                    ++wires_set_up;
+                }
+            lazy_wires = true;
+        } else {
+            for (auto wire : ctx->getWires()) {
+                PerWireData pwd = make_wire_data(wire);
+                if (use_flat_index) {
+                    int idx = ctx->getFlatWireIndex(wire);
+                    NPNR_ASSERT(idx >= 0 && idx < flat_count);
+                    NPNR_ASSERT(flat_wires.at(idx).w == WireId());
+                    flat_wires.at(idx) = pwd;
+                } else {
+                    wire_to_idx[wire] = int(flat_wires.size());
+                    flat_wires.push_back(pwd);
                 }
+                ++wires_set_up;
             }
-
-            BoundingBox wire_loc = ctx->getRouteBoundingBox(wire, wire);
-            pwd.x = (wire_loc.x0 + wire_loc.x1) / 2;
-            pwd.y = (wire_loc.y0 + wire_loc.y1) / 2;
-
-            wire_to_idx[wire] = int(flat_wires.size());
-            flat_wires.push_back(pwd);
         }
 
         for (auto &net_pair : ctx->nets) {
@@ -227,6 +316,40 @@ struct Router2
                 }
             }
         }
+
+        if (cfg.existing_routing)
+            remove_stale_wires();
+    }
+
+    // Existing routing that isn't part of any legally routed arc, e.g. left over from routing to a sink that has since
+    // moved or been disconnected. It would otherwise count as congestion forever, as no arc ever rips it up.
+    std::vector<bool> net_had_stale_wires;
+
+    void remove_stale_wires()
+    {
+        net_had_stale_wires.assign(nets.size(), false);
+        std::vector<WireId> stale_wires;
+        for (size_t i = 0; i < nets.size(); i++) {
+            NetInfo *ni = nets_by_udata.at(i);
+            auto &nd = nets.at(i);
+#ifdef ARCH_ECP5
+            if (ni->is_global)
+                continue;
+#endif
+            // Nets that are never routed keep whatever they are bound to
+            if (ni->driver.cell == nullptr)
+                continue;
+            stale_wires.clear();
+            for (auto &w : nd.wires)
+                if (w.second.second == 0 && w.first != nd.src_wire &&
+                    ni->wires.at(w.first).strength <= STRENGTH_STRONG)
+                    stale_wires.push_back(w.first);
+            for (auto w : stale_wires) {
+                --wire_data(w).curr_cong;
+                nd.wires.erase(w);
+            }
+            net_had_stale_wires.at(i) = !stale_wires.empty();
+        }
     }
 
     struct QueuedWire
@@ -256,6 +379,8 @@ struct Router2
 
     struct ThreadContext
     {
+        explicit ThreadContext(int queue_arity) : fwd_queue(queue_arity), bwd_queue(queue_arity) {}
+
         // Nets to route
         std::vector<NetInfo *> route_nets;
         // Nets that failed routing
@@ -263,11 +388,15 @@ struct Router2
 
         std::vector<std::pair<store_index<PortRef>, size_t>> route_arcs;
 
-        std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> fwd_queue, bwd_queue;
+        // Kept between arcs, so that their storage is reused
+        RouteQueue<QueuedWire, QueuedWire::Greater> fwd_queue, bwd_queue;
         // Special case where one net has multiple logical arcs to the same physical sink
         pool<WireId> processed_sinks;
 
-        std::vector<int> dirty_wires;
+        uint32_t visit_epoch = 0;
+
+        // Estimated routing effort, used to schedule the largest regions first
+        int64_t work = 0;
 
         // Thread bounding box
         BoundingBox bb;
@@ -277,6 +406,10 @@ struct Router2
         // Used to add existing routing to the heap
         pool<WireId> in_wire_by_loc;
         dict<std::pair<int, int>, pool<WireId>> wire_by_loc;
+
+        // Search effort statistics
+        int arcs_searched = 0;
+        int64_t wires_explored = 0;
     };
 
     bool thread_test_wire(ThreadContext &t, PerWireData &w)
@@ -414,7 +547,7 @@ struct Router2
         WireId src = nets.at(net->udata).src_wire;
         WireId cursor = ad.sink_wire;
         while (cursor != src) {
-            size_t wire_idx = wire_to_idx.at(cursor);
+            size_t wire_idx = wire_index(cursor);
             PipId pip = nd.wires.at(cursor).first;
             bind_pip_internal(nd, usr, wire_idx, pip);
             cursor = ctx->getPipSrcWire(pip);
@@ -515,15 +648,16 @@ struct Router2
         } while (did_something);
     }
 
-    void reset_wires(ThreadContext &t)
+    void reset_wires(ThreadContext &t) { t.visit_epoch = next_visit_epoch++; }
+
+    void rewind_visit_epochs()
     {
-        for (auto w : t.dirty_wires) {
-            flat_wires[w].pip_fwd = PipId();
-            flat_wires[w].pip_bwd = PipId();
-            flat_wires[w].visited_fwd = false;
-            flat_wires[w].visited_bwd = false;
-        }
-        t.dirty_wires.clear();
+        // Must only be called when no routing threads are running
+        if (next_visit_epoch < std::numeric_limits<uint32_t>::max() / 2)
+            return;
+        for (auto &wv : wire_visit)
+            wv.epoch_fwd = wv.epoch_bwd = 0;
+        next_visit_epoch = 1;
     }
 
     // These nets have very-high-fanout pips and special rules must be followed (only working backwards) to avoid
@@ -565,23 +699,19 @@ struct Router2
     // Functions for marking wires as visited, and checking if they have already been visited
     void set_visited_fwd(ThreadContext &t, int wire, PipId pip)
     {
-        auto &wd = flat_wires.at(wire);
-        if (!wd.visited_fwd && !wd.visited_bwd)
-            t.dirty_wires.push_back(wire);
-        wd.pip_fwd = pip;
-        wd.visited_fwd = true;
+        auto &wv = wire_visit[wire];
+        wv.pip_fwd = pip;
+        wv.epoch_fwd = t.visit_epoch;
     }
     void set_visited_bwd(ThreadContext &t, int wire, PipId pip)
     {
-        auto &wd = flat_wires.at(wire);
-        if (!wd.visited_fwd && !wd.visited_bwd)
-            t.dirty_wires.push_back(wire);
-        wd.pip_bwd = pip;
-        wd.visited_bwd = true;
+        auto &wv = wire_visit[wire];
+        wv.pip_bwd = pip;
+        wv.epoch_bwd = t.visit_epoch;
     }
 
-    bool was_visited_fwd(int wire) { return flat_wires.at(wire).visited_fwd; }
-    bool was_visited_bwd(int wire) { return flat_wires.at(wire).visited_bwd; }
+    bool was_visited_fwd(ThreadContext &t, int wire) { return wire_visit[wire].epoch_fwd == t.visit_epoch; }
+    bool was_visited_bwd(ThreadContext &t, int wire) { return wire_visit[wire].epoch_bwd == t.visit_epoch; }
 
     float get_arc_crit(NetInfo *net, store_index<PortRef> i)
     {
@@ -613,8 +743,8 @@ struct Router2
         if (dst_wire == WireId())
             ARC_LOG_ERR("No wire found for port %s on destination cell %s.\n", ctx->nameOf(usr.port),
                         ctx->nameOf(usr.cell));
-        int src_wire_idx = wire_to_idx.at(src_wire);
-        int dst_wire_idx = wire_to_idx.at(dst_wire);
+        int src_wire_idx = wire_index(src_wire);
+        int dst_wire_idx = wire_index(dst_wire);
         // Calculate a timing weight based on criticality
         float crit = get_arc_crit(net, i);
         float crit_weight = (1.0f - std::pow(crit, 2));
@@ -636,14 +766,8 @@ struct Router2
 
         for (; mode < 2; mode++) {
             // Clear out the queues
-            if (!t.fwd_queue.empty()) {
-                std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
-                t.fwd_queue.swap(new_queue);
-            }
-            if (!t.bwd_queue.empty()) {
-                std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
-                t.bwd_queue.swap(new_queue);
-            }
+            t.fwd_queue.clear();
+            t.bwd_queue.clear();
             // Unvisit any previously visited wires
             reset_wires(t);
 
@@ -653,7 +777,7 @@ struct Router2
             auto seed_queue_fwd = [&](WireId wire, float wire_cost = 0) {
                 WireScore base_score;
                 base_score.cost = wire_cost;
-                int wire_idx = wire_to_idx.at(wire);
+                int wire_idx = wire_index(wire);
                 base_score.togo_cost = get_togo_cost(net, i, wire_idx, dst_wire, false, crit_weight);
                 t.fwd_queue.push(QueuedWire(wire_idx, base_score));
                 set_visited_fwd(t, wire_idx, PipId());
@@ -683,7 +807,7 @@ struct Router2
             auto seed_queue_bwd = [&](WireId wire) {
                 WireScore base_score;
                 base_score.cost = 0;
-                int wire_idx = wire_to_idx.at(wire);
+                int wire_idx = wire_index(wire);
                 base_score.togo_cost = get_togo_cost(net, i, wire_idx, src_wire, true, crit_weight);
                 t.bwd_queue.push(QueuedWire(wire_idx, base_score));
                 set_visited_bwd(t, wire_idx, PipId());
@@ -705,7 +829,7 @@ struct Router2
                     auto curr = t.fwd_queue.top();
                     t.fwd_queue.pop();
                     ++explored;
-                    if (was_visited_bwd(curr.wire)) {
+                    if (was_visited_bwd(t, curr.wire)) {
                         // Meet in the middle; done
                         midpoint_wire = curr.wire;
                         break;
@@ -718,8 +842,8 @@ struct Router2
                         if (!ctx->checkPipAvailForNet(dh, net))
                             continue;
                         WireId next = ctx->getPipDstWire(dh);
-                        int next_idx = wire_to_idx.at(next);
-                        if (was_visited_fwd(next_idx)) {
+                        int next_idx = wire_index(next);
+                        if (was_visited_fwd(t, next_idx)) {
                             // Don't expand the same node twice.
                             continue;
                         }
@@ -748,7 +872,7 @@ struct Router2
                     auto curr = t.bwd_queue.top();
                     t.bwd_queue.pop();
                     ++explored;
-                    if (was_visited_fwd(curr.wire)) {
+                    if (was_visited_fwd(t, curr.wire)) {
                         // Meet in the middle; done
                         midpoint_wire = curr.wire;
                         break;
@@ -768,8 +892,8 @@ struct Router2
                         if (!ctx->checkPipAvailForNet(uh, net))
                             continue;
                         WireId next = ctx->getPipSrcWire(uh);
-                        int next_idx = wire_to_idx.at(next);
-                        if (was_visited_bwd(next_idx)) {
+                        int next_idx = wire_index(next);
+                        if (was_visited_bwd(t, next_idx)) {
                             // Don't expand the same node twice.
                             continue;
                         }
@@ -797,8 +921,8 @@ struct Router2
         if (midpoint_wire != -1) {
             ROUTE_LOG_DBG("   Routed (explored %d wires): ", explored);
             int cursor_bwd = midpoint_wire;
-            while (was_visited_fwd(cursor_bwd)) {
-                PipId pip = flat_wires.at(cursor_bwd).pip_fwd;
+            while (was_visited_fwd(t, cursor_bwd)) {
+                PipId pip = wire_visit.at(cursor_bwd).pip_fwd;
                 if (pip == PipId() && cursor_bwd != src_wire_idx)
                     break;
                 bind_pip_internal(nd, i, cursor_bwd, pip);
@@ -812,7 +936,7 @@ struct Router2
                 }
                 ROUTE_LOG_DBG("         fwd pip: %s (%d, %d)\n", ctx->nameOfPip(pip), ctx->getPipLocation(pip).x,
                               ctx->getPipLocation(pip).y);
-                cursor_bwd = wire_to_idx.at(ctx->getPipSrcWire(pip));
+                cursor_bwd = wire_index(ctx->getPipSrcWire(pip));
             }
 
             while (cursor_bwd != src_wire_idx) {
@@ -830,20 +954,20 @@ struct Router2
                 bind_pip_internal(nd, i, cursor_bwd, pip);
                 if (pip == PipId())
                     break;
-                cursor_bwd = wire_to_idx.at(ctx->getPipSrcWire(pip));
+                cursor_bwd = wire_index(ctx->getPipSrcWire(pip));
             }
 
             NPNR_ASSERT(cursor_bwd == src_wire_idx);
 
             int cursor_fwd = midpoint_wire;
-            while (was_visited_bwd(cursor_fwd)) {
-                PipId pip = flat_wires.at(cursor_fwd).pip_bwd;
+            while (was_visited_bwd(t, cursor_fwd)) {
+                PipId pip = wire_visit.at(cursor_fwd).pip_bwd;
                 if (pip == PipId()) {
                     break;
                 }
                 ROUTE_LOG_DBG("         bwd pip: %s (%d, %d)\n", ctx->nameOfPip(pip), ctx->getPipLocation(pip).x,
                               ctx->getPipLocation(pip).y);
-                cursor_fwd = wire_to_idx.at(ctx->getPipDstWire(pip));
+                cursor_fwd = wire_index(ctx->getPipDstWire(pip));
                 bind_pip_internal(nd, i, cursor_fwd, pip);
                 if (ctx->debug && !is_mt) {
                     auto &wd = flat_wires.at(cursor_fwd);
@@ -865,6 +989,8 @@ struct Router2
                           is_bb, std::chrono::duration<float>(arc_end - arc_start).count());
             result = ARC_RETRY_WITHOUT_BB;
         }
+        ++t.arcs_searched;
+        t.wires_explored += explored;
         reset_wires(t);
         return result;
     }
@@ -946,10 +1072,11 @@ struct Router2
                 }
             }
         }
-        if (cfg.perf_profile) {
+        if (cfg.perf_profile || !cfg.trace.empty()) {
             auto rend = std::chrono::high_resolution_clock::now();
-            nets.at(net->udata).total_route_us +=
-                    (std::chrono::duration_cast<std::chrono::microseconds>(rend - rstart).count());
+            int route_us = std::chrono::duration_cast<std::chrono::microseconds>(rend - rstart).count();
+            nets.at(net->udata).total_route_us += route_us;
+            nets.at(net->udata).iter_route_us += route_us;
         }
         return !have_failures;
     }
@@ -1095,11 +1222,15 @@ struct Router2
 
         bool success = true;
         std::vector<WireId> net_wires;
-        for (auto net : nets_by_udata) {
+        auto skip_net = [&](NetInfo *net) {
 #ifdef ARCH_ECP5
             if (net->is_global)
-                continue;
+                return true;
 #endif
+            // Nets that were never rerouted keep their existing binding
+            return cfg.incremental && !net_rerouted.at(net->udata);
+        };
+        auto ripup_net = [&](NetInfo *net) {
             // Ripup wires and pips used by the net in nextpnr's structures
             net_wires.clear();
             for (auto &w : net->wires) {
@@ -1116,7 +1247,8 @@ struct Router2
             if (ctx->debug) {
                 log("Ripped up %zu wires on net %s\n", net_wires.size(), ctx->nameOf(net));
             }
-
+        };
+        auto bind_net = [&](NetInfo *net) {
             // Bind the arcs using the routes we have discovered
             for (auto usr : net->users.enumerate()) {
                 for (size_t phys_pin = 0; phys_pin < nets.at(net->udata).arcs.at(usr.index.idx()).size(); phys_pin++) {
@@ -1126,6 +1258,22 @@ struct Router2
                     }
                 }
             }
+        };
+        if (cfg.existing_routing) {
+            // Rip up all nets before binding any, so that a new route can't clash with another net's old routing
+            for (auto net : nets_by_udata)
+                if (!skip_net(net))
+                    ripup_net(net);
+            for (auto net : nets_by_udata)
+                if (!skip_net(net))
+                    bind_net(net);
+        } else {
+            for (auto net : nets_by_udata) {
+                if (skip_net(net))
+                    continue;
+                ripup_net(net);
+                bind_net(net);
+            }
         }
 
         // Check that the arch is still internally consistent!
@@ -1140,6 +1288,8 @@ struct Router2
         size_t max_cong = 0;
         // Build histogram
         for (auto &wd : flat_wires) {
+            if (wd.w == WireId())
+                continue;
             size_t val = wd.curr_cong;
             IdString type = ctx->getWireType(wd.w);
             max_cong = std::max(max_cong, val);
@@ -1160,51 +1310,20 @@ struct Router2
         }
     }
 
-    int mid_x = 0, mid_y = 0;
+    // Search effort for the current iteration and the whole run
+    int iter_arcs_searched = 0, total_arcs_searched = 0;
+    int64_t iter_wires_explored = 0, total_wires_explored = 0;
+    // Wall time of do_route, only collected for perf_profile, and its cache misses, only for count_cache_misses
+    double total_search_time = 0;
+    int64_t total_cache_misses = 0;
+    std::unique_ptr<CacheMissCounter> cache_misses;
 
-    void partition_nets()
+    void gather_search_stats(ThreadContext &t)
     {
-        // Create a histogram of positions in X and Y positions
-        std::map<int, int> cxs, cys;
-        for (auto &n : nets) {
-            if (n.cx != -1)
-                ++cxs[n.cx];
-            if (n.cy != -1)
-                ++cys[n.cy];
-        }
-        // 4-way split for now
-        int accum_x = 0, accum_y = 0;
-        int halfway = int(nets.size()) / 2;
-        for (auto &p : cxs) {
-            if (accum_x < halfway && (accum_x + p.second) >= halfway)
-                mid_x = p.first;
-            accum_x += p.second;
-        }
-        for (auto &p : cys) {
-            if (accum_y < halfway && (accum_y + p.second) >= halfway)
-                mid_y = p.first;
-            accum_y += p.second;
-        }
-        if (ctx->verbose) {
-            log_info("    x splitpoint: %d\n", mid_x);
-            log_info("    y splitpoint: %d\n", mid_y);
-        }
-        std::vector<int> bins(5, 0);
-        for (auto &n : nets) {
-            if (n.bb.x0 < mid_x && n.bb.x1 < mid_x && n.bb.y0 < mid_y && n.bb.y1 < mid_y)
-                ++bins[0]; // TL
-            else if (n.bb.x0 >= mid_x && n.bb.x1 >= mid_x && n.bb.y0 < mid_y && n.bb.y1 < mid_y)
-                ++bins[1]; // TR
-            else if (n.bb.x0 < mid_x && n.bb.x1 < mid_x && n.bb.y0 >= mid_y && n.bb.y1 >= mid_y)
-                ++bins[2]; // BL
-            else if (n.bb.x0 >= mid_x && n.bb.x1 >= mid_x && n.bb.y0 >= mid_y && n.bb.y1 >= mid_y)
-                ++bins[3]; // BR
-            else
-                ++bins[4]; // cross-boundary
-        }
-        if (ctx->verbose)
-            for (int i = 0; i < 5; i++)
-                log_info("        bin %d N=%d\n", i, bins[i]);
+        iter_arcs_searched += t.arcs_searched;
+        iter_wires_explored += t.wires_explored;
+        t.arcs_searched = 0;
+        t.wires_explored = 0;
     }
 
     void router_thread(ThreadContext &t, bool is_mt)
@@ -1216,115 +1335,244 @@ struct Router2
         }
     }
 
-    void do_route()
+    // Recursive bisection partitioning for multithreaded routing. Each region is split across its longer axis at the
+    // weighted median of net centres; nets entirely on one side of the split go into the corresponding child region.
+    // Nets that cross the split are routed afterwards, either in one of two strips either side of a perpendicular split
+    // or, failing that, in the parent region itself. Tasks in the same phase cover disjoint regions and so can be run
+    // in parallel; phases are ordered deepest first, with the whole-chip remainder last.
+    struct RoutePhase
     {
-        // Don't multithread if fewer than 200 nets (heuristic)
-        if (route_queue.size() < 200) {
-            ThreadContext st;
-            st.rng.rngseed(ctx->rng64());
-            st.bb = BoundingBox(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-            for (size_t j = 0; j < route_queue.size(); j++) {
-                route_net(st, nets_by_udata[route_queue[j]], false);
-            }
+        std::vector<ThreadContext> tasks;
+    };
+
+    int64_t net_route_work(int net)
+    {
+        auto &nd = nets.at(net);
+        return int64_t(nd.arcs.size()) * (1 + (nd.bb.x1 - nd.bb.x0) + (nd.bb.y1 - nd.bb.y0));
+    }
+
+    void add_route_task(std::vector<RoutePhase> &phases, int phase, const BoundingBox &region,
+                        const std::vector<int> &region_nets)
+    {
+        if (region_nets.empty())
             return;
+        if (int(phases.size()) <= phase)
+            phases.resize(phase + 1);
+        phases.at(phase).tasks.emplace_back(cfg.queue_arity);
+        auto &task = phases.at(phase).tasks.back();
+        task.bb = region;
+        for (int n : region_nets) {
+            task.route_nets.push_back(nets_by_udata.at(n));
+            task.work += net_route_work(n);
         }
-        const int Nq = 4, Nv = 2, Nh = 2;
-        const int N = Nq + Nv + Nh;
-        std::vector<ThreadContext> tcs(N + 1);
-        for (auto &th : tcs) {
-            th.rng.rngseed(ctx->rng64());
-        }
-        int le_x = mid_x;
-        int rs_x = mid_x;
-        int le_y = mid_y;
-        int rs_y = mid_y;
-        // Set up thread bounding boxes
-        tcs.at(0).bb = BoundingBox(0, 0, mid_x, mid_y);
-        tcs.at(1).bb = BoundingBox(mid_x + 1, 0, std::numeric_limits<int>::max(), le_y);
-        tcs.at(2).bb = BoundingBox(0, mid_y + 1, mid_x, std::numeric_limits<int>::max());
-        tcs.at(3).bb =
-                BoundingBox(mid_x + 1, mid_y + 1, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        tcs.at(4).bb = BoundingBox(0, 0, std::numeric_limits<int>::max(), mid_y);
-        tcs.at(5).bb = BoundingBox(0, mid_y + 1, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        tcs.at(6).bb = BoundingBox(0, 0, mid_x, std::numeric_limits<int>::max());
-        tcs.at(7).bb = BoundingBox(mid_x + 1, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        tcs.at(8).bb = BoundingBox(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        for (auto n : route_queue) {
+    }
+
+    // Find the work-weighted median net centre along an axis; returns false if there's no useful split
+    bool find_split(const std::vector<int> &region_nets, bool split_x, int lo, int hi, int &split)
+    {
+        std::map<int, int64_t> hist;
+        int64_t total = 0;
+        for (int n : region_nets) {
             auto &nd = nets.at(n);
-            auto ni = nets_by_udata.at(n);
-            int bin = N;
-            // Quadrants
-            if (nd.bb.x0 < le_x && nd.bb.x1 < le_x && nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = 0;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x && nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = 1;
-            else if (nd.bb.x0 < le_x && nd.bb.x1 < le_x && nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = 2;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x && nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = 3;
-            // Vertical split
-            else if (nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = Nq + 0;
-            else if (nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = Nq + 1;
-            // Horizontal split
-            else if (nd.bb.x0 < le_x && nd.bb.x1 < le_x)
-                bin = Nq + Nv + 0;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x)
-                bin = Nq + Nv + 1;
-            tcs.at(bin).route_nets.push_back(ni);
+            int c = split_x ? nd.cx : nd.cy;
+            if (c == -1)
+                continue;
+            int64_t w = net_route_work(n);
+            hist[c] += w;
+            total += w;
         }
-        if (ctx->verbose)
-            log_info("%d/%d nets not multi-threadable\n", int(tcs.at(N).route_nets.size()), int(route_queue.size()));
-#ifdef NPNR_DISABLE_THREADS
-        // Singlethreaded routing - quadrants
-        for (int i = 0; i < Nq; i++) {
-            router_thread(tcs.at(i), /*is_mt=*/false);
+        int64_t accum = 0;
+        split = -1;
+        for (auto &p : hist) {
+            accum += p.second;
+            if (accum * 2 >= total) {
+                split = p.first;
+                break;
+            }
+        }
+        return split > lo && split < hi;
+    }
+
+    void partition_region(std::vector<RoutePhase> &phases, const BoundingBox &region, const std::vector<int> &region_nets,
+                          int depth, int max_depth)
+    {
+        // Regions with few nets aren't worth splitting further, the crossing nets would dominate
+        const int min_region_nets = 50;
+        // Phases run in order, so the deepest regions get the lowest phase indices
+        int split_phase = 2 * (max_depth - depth), remainder_phase = split_phase + 1;
+
+        int x1 = std::min(region.x1, ctx->getGridDimX() - 1), y1 = std::min(region.y1, ctx->getGridDimY() - 1);
+        bool split_x = (x1 - region.x0) >= (y1 - region.y0);
+        int split;
+        if (depth == max_depth || int(region_nets.size()) < min_region_nets ||
+            !find_split(region_nets, split_x, split_x ? region.x0 : region.y0, split_x ? x1 : y1, split)) {
+            add_route_task(phases, (depth == 0) ? remainder_phase : split_phase, region, region_nets);
+            return;
         }
-        // Vertical splits
-        for (int i = Nq; i < Nq + Nv; i++) {
-            router_thread(tcs.at(i), /*is_mt=*/false);
+
+        std::vector<int> lo_nets, hi_nets, cross_nets;
+        for (int n : region_nets) {
+            auto &bb = nets.at(n).bb;
+            if ((split_x ? bb.x1 : bb.y1) < split)
+                lo_nets.push_back(n);
+            else if ((split_x ? bb.x0 : bb.y0) > split)
+                hi_nets.push_back(n);
+            else
+                cross_nets.push_back(n);
+        }
+        BoundingBox lo_region = region, hi_region = region;
+        (split_x ? lo_region.x1 : lo_region.y1) = split;
+        (split_x ? hi_region.x0 : hi_region.y0) = split + 1;
+        partition_region(phases, lo_region, lo_nets, depth + 1, max_depth);
+        partition_region(phases, hi_region, hi_nets, depth + 1, max_depth);
+
+        // Nets crossing the split: try routing these in two strips across the perpendicular axis
+        int strip_split;
+        if (int(cross_nets.size()) < min_region_nets ||
+            !find_split(cross_nets, !split_x, split_x ? region.y0 : region.x0, split_x ? y1 : x1, strip_split)) {
+            add_route_task(phases, remainder_phase, region, cross_nets);
+            return;
         }
-        // Horizontal splits
-        for (int i = Nq + Nv; i < Nq + Nv + Nh; i++) {
-            router_thread(tcs.at(i), /*is_mt=*/false);
+        std::vector<int> lo_strip, hi_strip, remainder;
+        for (int n : cross_nets) {
+            auto &bb = nets.at(n).bb;
+            if ((split_x ? bb.y1 : bb.x1) < strip_split)
+                lo_strip.push_back(n);
+            else if ((split_x ? bb.y0 : bb.x0) > strip_split)
+                hi_strip.push_back(n);
+            else
+                remainder.push_back(n);
         }
+        BoundingBox lo_strip_region = region, hi_strip_region = region;
+        (split_x ? lo_strip_region.y1 : lo_strip_region.x1) = strip_split;
+        (split_x ? hi_strip_region.y0 : hi_strip_region.x0) = strip_split + 1;
+        add_route_task(phases, split_phase, lo_strip_region, lo_strip);
+        add_route_task(phases, split_phase, hi_strip_region, hi_strip);
+        add_route_task(phases, remainder_phase, region, remainder);
+    }
+
+    // Run all the tasks in a phase, largest first, across a pool of threads that each take the next task when done
+    void run_route_phase(RoutePhase &phase, std::vector<double> &thread_busy)
+    {
+        std::vector<size_t> order(phase.tasks.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return phase.tasks.at(a).work > phase.tasks.at(b).work; });
+        std::atomic<size_t> next_task(0);
+        auto worker = [&](int thread_idx) {
+            for (size_t i = next_task++; i < order.size(); i = next_task++) {
+                auto tstart = std::chrono::high_resolution_clock::now();
+                router_thread(phase.tasks.at(order.at(i)), /*is_mt=*/true);
+                auto tend = std::chrono::high_resolution_clock::now();
+                thread_busy.at(thread_idx) += std::chrono::duration<double>(tend - tstart).count();
+            }
+        };
+#ifdef NPNR_DISABLE_THREADS
+        worker(0);
 #else
-        // Multithreaded part of routing - quadrants
+        int num_threads = std::min(int(thread_busy.size()), int(phase.tasks.size()));
         std::vector<boost::thread> threads;
-        for (int i = 0; i < Nq; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i), /*is_mt=*/true); });
-        }
+        for (int i = 1; i < num_threads; i++)
+            threads.emplace_back([&worker, i]() { worker(i); });
+        worker(0);
         for (auto &t : threads)
             t.join();
-        threads.clear();
-        // Vertical splits
-        for (int i = Nq; i < Nq + Nv; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i), /*is_mt=*/true); });
+#endif
+    }
+
+    // Thread utilisation of the last do_route, for the trace
+    double iter_mt_time = 0, iter_st_time = 0;
+    std::vector<double> iter_thread_busy;
+
+    void do_route()
+    {
+        rewind_visit_epochs();
+        int num_threads = std::max(1, cfg.threads);
+        auto route_start = std::chrono::high_resolution_clock::now();
+        iter_thread_busy.clear();
+        iter_mt_time = 0;
+        // Don't multithread if fewer than 200 nets (heuristic)
+        if (route_queue.size() < 200 || num_threads == 1) {
+            ThreadContext st(cfg.queue_arity);
+            st.rng.rngseed(ctx->rng64());
+            st.bb = BoundingBox(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+            for (size_t j = 0; j < route_queue.size(); j++) {
+                route_net(st, nets_by_udata[route_queue[j]], false);
+            }
+            gather_search_stats(st);
+            auto route_end = std::chrono::high_resolution_clock::now();
+            iter_st_time = std::chrono::duration<double>(route_end - route_start).count();
+            return;
         }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-        // Horizontal splits
-        for (int i = Nq + Nv; i < Nq + Nv + Nh; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i), /*is_mt=*/true); });
+        // Aim for about twice as many leaf regions as threads, so large regions can be balanced against small ones
+        int max_depth = 1;
+        while ((1 << max_depth) < 2 * num_threads)
+            ++max_depth;
+        std::vector<RoutePhase> phases;
+        const BoundingBox chip(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+        partition_region(phases, chip, route_queue, 0, max_depth);
+        // Only the whole-chip region is added to the last phase. This can't be multithreaded, so route it at the end
+        // with the failed nets rather than as a phase.
+        std::vector<NetInfo *> st_nets;
+        if (int(phases.size()) == 2 * max_depth + 2) {
+            NPNR_ASSERT(phases.back().tasks.size() == 1);
+            st_nets = phases.back().tasks.front().route_nets;
+            phases.pop_back();
         }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-#endif
+        // Seed in a fixed order so results don't depend on scheduling
+        int num_tasks = 0;
+        for (auto &phase : phases)
+            for (auto &task : phase.tasks) {
+                task.rng.rngseed(ctx->rng64());
+                ++num_tasks;
+            }
+        if (ctx->verbose)
+            log_info("%d/%d nets not multi-threadable, %d regions in %d phases\n", int(st_nets.size()),
+                     int(route_queue.size()), num_tasks, int(phases.size()));
+
+        std::vector<double> thread_busy(num_threads, 0.0);
+        for (auto &phase : phases)
+            run_route_phase(phase, thread_busy);
+        auto mt_end = std::chrono::high_resolution_clock::now();
+
         // Singlethreaded part of routing - nets that cross partitions
         // or don't fit within bounding box
-        for (auto st_net : tcs.at(N).route_nets)
-            route_net(tcs.at(N), st_net, false);
+        ThreadContext st(cfg.queue_arity);
+        st.rng.rngseed(ctx->rng64());
+        st.bb = chip;
+        for (auto st_net : st_nets)
+            route_net(st, st_net, false);
         // Failed nets
-        for (int i = 0; i < N; i++)
-            for (auto fail : tcs.at(i).failed_nets)
-                route_net(tcs.at(N), fail, false);
+        for (auto &phase : phases)
+            for (auto &task : phase.tasks)
+                for (auto fail : task.failed_nets)
+                    route_net(st, fail, false);
+        auto route_end = std::chrono::high_resolution_clock::now();
+
+        for (auto &phase : phases)
+            for (auto &task : phase.tasks)
+                gather_search_stats(task);
+        gather_search_stats(st);
+
+        double mt_time = std::chrono::duration<double>(mt_end - route_start).count();
+        double st_time = std::chrono::duration<double>(route_end - mt_end).count();
+        iter_mt_time = mt_time;
+        iter_st_time = st_time;
+        iter_thread_busy = thread_busy;
+
+        if (cfg.perf_profile || ctx->verbose) {
+            auto util = [&](double busy) { return mt_time > 0 ? (100.0 * busy / mt_time) : 100.0; };
+            double busy_min = *std::min_element(thread_busy.begin(), thread_busy.end());
+            double busy_max = *std::max_element(thread_busy.begin(), thread_busy.end());
+            double busy_avg = std::accumulate(thread_busy.begin(), thread_busy.end(), 0.0) / num_threads;
+            log_info("        %d threads: %.02fs multithreaded (utilisation min %.0f%% avg %.0f%% max %.0f%%), "
+                     "%.02fs single threaded\n",
+                     num_threads, mt_time, util(busy_min), util(busy_avg), util(busy_max), st_time);
+            if (ctx->verbose)
+                for (int i = 0; i < num_threads; i++)
+                    log_info("            thread %2d busy %.02fs (%.0f%%)\n", i, thread_busy.at(i),
+                             util(thread_busy.at(i)));
+        }
     }
 
     delay_t get_route_delay(int net, store_index<PortRef> usr_idx, int phys_idx)
@@ -1349,9 +1597,9 @@ struct Router2
         return delay;
     }
 
-    void update_route_delays()
+    void update_route_delays(const std::vector<int> &net_list)
     {
-        for (int net : route_queue) {
+        for (int net : net_list) {
             NetInfo *ni = nets_by_udata.at(net);
 #ifdef ARCH_ECP5
             if (ni->is_global)
@@ -1367,6 +1615,130 @@ struct Router2
         }
     }
 
+    // Incremental (ECO) routing: nets whose arcs are all still legally routed by the existing routing, and that had no
+    // stale wires, keep it and are only rerouted if they end up in congestion
+    std::vector<bool> net_rerouted;
+
+    void setup_incremental()
+    {
+        std::vector<int> kept_nets;
+        for (size_t i = 0; i < nets_by_udata.size(); i++) {
+            NetInfo *ni = nets_by_udata.at(i);
+            auto &nd = nets.at(i);
+#ifdef ARCH_ECP5
+            if (ni->is_global)
+                continue;
+#endif
+            if (ni->driver.cell == nullptr)
+                continue;
+            bool needs_route = false;
+            for (auto &usr_arcs : nd.arcs)
+                for (auto &ad : usr_arcs)
+                    needs_route |= !ad.routed;
+            if (needs_route || net_had_stale_wires.at(i))
+                route_queue.push_back(i);
+            else
+                kept_nets.push_back(i);
+        }
+        // Kept nets are not routed in the first iteration, so their delays must be set up front
+        update_route_delays(kept_nets);
+        log_info("Incremental routing: %d/%d nets need routing.\n", int(route_queue.size()),
+                 int(nets_by_udata.size()));
+    }
+
+    // Machine-readable per-iteration statistics, written to cfg.trace as routing goes
+    json11::Json::array trace_iters;
+
+    json11::Json::array trace_nets_by_time(bool this_iter, int count)
+    {
+        std::vector<std::pair<int, int>> nets_by_time;
+        for (size_t i = 0; i < nets.size(); i++) {
+            int us = this_iter ? nets.at(i).iter_route_us : nets.at(i).total_route_us;
+            if (us > 0)
+                nets_by_time.emplace_back(us, int(i));
+        }
+        std::sort(nets_by_time.begin(), nets_by_time.end(), std::greater<std::pair<int, int>>());
+        json11::Json::array result;
+        for (int i = 0; i < std::min(int(nets_by_time.size()), count); i++) {
+            const NetInfo *ni = nets_by_udata.at(nets_by_time.at(i).second);
+            const auto &nd = nets.at(nets_by_time.at(i).second);
+            result.push_back(json11::Json::object{
+                    {"net", ni->name.str(ctx)},
+                    {"users", int(ni->users.entries())},
+                    {"hpwl", nd.hpwl},
+                    {"fail_count", nd.fail_count},
+                    {"route_us", nets_by_time.at(i).first},
+            });
+        }
+        return result;
+    }
+
+    void add_trace_iter(int iter, double iter_time, int nets_routed, int tmgfail)
+    {
+        // Overuse by wire type (the wire intent on xilinx)
+        dict<IdString, std::pair<int, int>> overuse_by_type;
+        for (auto &wd : flat_wires) {
+            if (wd.curr_cong <= 1)
+                continue;
+            auto &entry = overuse_by_type[ctx->getWireType(wd.w)];
+            entry.first += 1;
+            entry.second += wd.curr_cong - 1;
+        }
+        json11::Json::object overuse_json;
+        for (auto &entry : overuse_by_type)
+            overuse_json[entry.first.str(ctx)] =
+                    json11::Json::object{{"wires", entry.second.first}, {"overuse", entry.second.second}};
+
+        json11::Json::object iter_json{
+                {"iter", iter},
+                {"time", iter_time},
+                {"nets_routed", nets_routed},
+                {"arcs_searched", iter_arcs_searched},
+                {"wires_explored", double(iter_wires_explored)},
+                {"wires", total_wire_use},
+                {"overused", overused_wires},
+                {"overuse", total_overuse},
+                {"overuse_by_type", overuse_json},
+                {"tmgfail", tmgfail},
+                {"curr_cong_weight", curr_cong_weight},
+                {"multithreaded_time", iter_mt_time},
+                {"single_threaded_time", iter_st_time},
+                {"thread_busy", json11::Json(iter_thread_busy)},
+                {"slowest_nets", trace_nets_by_time(true, 10)},
+        };
+        trace_iters.push_back(iter_json);
+    }
+
+    // Rewritten after every iteration, so that a run that is killed or never converges still leaves the iterations
+    // done so far behind. The file is replaced by a rename so it is never seen half written.
+    void write_trace(double total_time, bool complete)
+    {
+        std::string tmp_name = cfg.trace + ".tmp";
+        {
+            std::ofstream out(tmp_name);
+            if (!out)
+                log_error("Failed to open router2 trace %s for writing.\n", tmp_name.c_str());
+            json11::Json::object trace_json{
+                    {"threads", std::max(1, cfg.threads)},
+                    {"complete", complete},
+                    {"time", total_time},
+                    {"arcs_searched", total_arcs_searched},
+                    {"wires_explored", double(total_wires_explored)},
+                    {"iterations", trace_iters},
+                    {"expensive_nets", trace_nets_by_time(false, cfg.trace_top_nets)},
+            };
+            out << json11::Json(trace_json).dump() << std::endl;
+            if (!out)
+                log_error("Failed to write router2 trace %s.\n", tmp_name.c_str());
+        }
+        // rename won't replace an existing file on Windows
+        if (std::rename(tmp_name.c_str(), cfg.trace.c_str()) != 0 &&
+            (std::remove(cfg.trace.c_str()) != 0 || std::rename(tmp_name.c_str(), cfg.trace.c_str()) != 0))
+            log_error("Failed to rename router2 trace %s to %s.\n", tmp_name.c_str(), cfg.trace.c_str());
+        if (complete)
+            log_info("Wrote router2 trace to %s.\n", cfg.trace.c_str());
+    }
+
     void operator()()
     {
         log_info("Running router2...\n");
@@ -1374,27 +1746,35 @@ struct Router2
         auto rstart = std::chrono::high_resolution_clock::now();
         setup_nets();
         setup_wires();
+        wire_visit.resize(flat_wires.size());
         find_all_reserved_wires();
-        partition_nets();
         curr_cong_weight = cfg.init_curr_cong_weight;
         hist_cong_weight = cfg.hist_cong_weight;
-        ThreadContext st;
+        ThreadContext st(cfg.queue_arity);
         int iter = 1;
 
         ScopeLock<Context> lock(ctx);
 
-        for (size_t i = 0; i < nets_by_udata.size(); i++)
-            route_queue.push_back(i);
+        net_rerouted.resize(nets_by_udata.size());
+        if (cfg.incremental) {
+            setup_incremental();
+        } else {
+            for (size_t i = 0; i < nets_by_udata.size(); i++)
+                route_queue.push_back(i);
+        }
 
         timing_driven = ctx->setting<bool>("timing_driven");
         if (ctx->settings.count(ctx->id("router/tmg_ripup")))
             timing_driven_ripup = timing_driven && ctx->setting<bool>("router/tmg_ripup");
         else
             timing_driven_ripup = false;
+        if (cfg.count_cache_misses)
+            cache_misses.reset(new CacheMissCounter());
         log_info("Running main router loop...\n");
         if (timing_driven)
             tmg.run(true);
         do {
+            auto iter_start = std::chrono::high_resolution_clock::now();
             ctx->sorted_shuffle(route_queue);
 
             if (timing_driven && int(route_queue.size()) >= 30) {
@@ -1411,8 +1791,28 @@ struct Router2
                                  [&](int na, int nb) { return nets.at(na).max_crit > nets.at(nb).max_crit; });
             }
 
-            do_route();
-            update_route_delays();
+            iter_arcs_searched = 0;
+            iter_wires_explored = 0;
+            int nets_routed = int(route_queue.size());
+            for (int n : route_queue)
+                net_rerouted.at(n) = true;
+            if (!cfg.trace.empty())
+                for (auto &nd : nets)
+                    nd.iter_route_us = 0;
+            if (cfg.perf_profile) {
+                auto search_start = std::chrono::high_resolution_clock::now();
+                int64_t misses_before = cache_misses ? cache_misses->get() : 0;
+                do_route();
+                if (cache_misses)
+                    total_cache_misses += cache_misses->get() - misses_before;
+                auto search_end = std::chrono::high_resolution_clock::now();
+                total_search_time += std::chrono::duration<double>(search_end - search_start).count();
+            } else {
+                do_route();
+            }
+            total_arcs_searched += iter_arcs_searched;
+            total_wires_explored += iter_wires_explored;
+            update_route_delays(route_queue);
             route_queue.clear();
             update_congestion();
 
@@ -1452,6 +1852,16 @@ struct Router2
                 log_info("    iter=%d wires=%d overused=%d overuse=%d archfail=%s\n", iter, total_wire_use,
                          overused_wires, total_overuse,
                          (overused_wires > 0 || tmgfail > 0) ? "NA" : std::to_string(arch_fail).c_str());
+            if (cfg.perf_profile)
+                log_info("        searched %d arcs, explored %lld wires (%.1f per arc)\n", iter_arcs_searched,
+                         (long long)iter_wires_explored,
+                         iter_wires_explored / double(std::max(iter_arcs_searched, 1)));
+            if (!cfg.trace.empty()) {
+                auto iter_end = std::chrono::high_resolution_clock::now();
+                add_trace_iter(iter, std::chrono::duration<double>(iter_end - iter_start).count(), nets_routed,
+                               tmgfail);
+                write_trace(std::chrono::duration<double>(iter_end - rstart).count(), false);
+            }
             ++iter;
             if (curr_cong_weight < 1e9)
                 curr_cong_weight += cfg.curr_cong_mult;
@@ -1470,7 +1880,26 @@ struct Router2
             }
         }
         auto rend = std::chrono::high_resolution_clock::now();
+        if (cfg.incremental)
+            log_info("Incremental routing rerouted %d/%d nets, set up %d/%d wires.\n",
+                     int(std::count(net_rerouted.begin(), net_rerouted.end(), true)), int(nets_by_udata.size()),
+                     wires_set_up.load(), int(flat_wires.size()));
         log_info("Router2 time %.02fs\n", std::chrono::duration<float>(rend - rstart).count());
+        if (!cfg.trace.empty())
+            write_trace(std::chrono::duration<double>(rend - rstart).count(), true);
+        if (cfg.perf_profile) {
+            double arcs = double(std::max(total_arcs_searched, 1));
+            log_info("Router2 searched %d arcs, explored %lld wires (%.1f per arc)\n", total_arcs_searched,
+                     (long long)total_wires_explored, total_wires_explored / arcs);
+            if (cache_misses && cache_misses->valid())
+                log_info("Router2 search time %.2fus per arc, %.1f cache misses per arc\n",
+                         1e6 * total_search_time / arcs, total_cache_misses / arcs);
+            else if (cache_misses)
+                log_info("Router2 search time %.2fus per arc (cache miss counter unavailable)\n",
+                         1e6 * total_search_time / arcs);
+            else
+                log_info("Router2 search time %.2fus per arc\n", 1e6 * total_search_time / arcs);
+        }
 
         log_info("Running router1 to check that route is legal...\n");
 
@@ -1501,10 +1930,22 @@ Router2Cfg::Router2Cfg(Context *ctx)
     curr_cong_mult = ctx->setting<float>("router2/currCongWeightMult", 2.0f);
     estimate_weight = ctx->setting<float>("router2/estimateWeight", 1.25f);
     perf_profile = ctx->setting<bool>("router2/perfProfile", false);
+    count_cache_misses = perf_profile;
+    threads = ctx->setting<int>("threads", 8);
+    queue_arity = ctx->setting<int>("router/queueArity", 2);
+    if (queue_arity < 2)
+        log_error("Router queue arity must be at least 2, got %d\n", queue_arity);
     if (ctx->settings.count(ctx->id("router2/heatmap")))
         heatmap = ctx->settings.at(ctx->id("router2/heatmap")).as_string();
     else
         heatmap = "";
+    if (ctx->settings.count(ctx->id("router2/trace")))
+        trace = ctx->settings.at(ctx->id("router2/trace")).as_string();
+    else
+        trace = "";
+    trace_top_nets = ctx->setting<int>("router2/traceTopNets", 100);
+    incremental = ctx->setting<bool>("router2/incremental", false);
+    existing_routing = incremental || ctx->setting<bool>("router/restoredRouting", false);
 }
 
 NEXTPNR_NAMESPACE_END
@@ -56,8 +56,28 @@ struct Router2Cfg
 
     // Print additional performance profiling information
     bool perf_profile = false;
+    // Also count hardware cache misses of the searches. Only set by --router2-perf-profile, as arches may turn on
+    // perf_profile by default
+    bool count_cache_misses = false;
+
+    // Number of threads used for routing nets in disjoint regions of the chip
+    int threads;
+
+    // Arity of the A* queue heaps
+    int queue_arity;
+
+    // Keep the existing routing of nets that are still legally routed, and only route the rest (e.g. after an ECO)
+    bool incremental = false;
+
+    // Routing other than the arch's own pre-routing exists when the router starts: restored from a checkpoint
+    // ("router/restoredRouting") or kept in incremental mode. Branches to moved sinks are then removed first, and every
+    // net is ripped up before any is rebound, so that new routes can't clash with another net's old routing
+    bool existing_routing = false;
 
     std::string heatmap;
+    // JSON file for per-iteration statistics, and the number of nets listed by total routing time at the end
+    std::string trace;
+    int trace_top_nets;
     std::function<float(Context *ctx, WireId wire, PipId pip, float crit_weight)> get_base_cost = default_base_cost;
 };
 
@@ -644,6 +644,16 @@ bool Arch::place()
     return true;
 }
 
+void Arch::postLoadPlacement()
+{
+    if (bool_or_default(settings, id("arch.ooc")))
+        for (auto &cell : cells)
+            cell.second->belStrength = STRENGTH_LOCKED;
+    remap_dsp_blocks();
+    getCtx()->settings[id_place] = 1;
+    archInfoToAttributes();
+}
+
 bool Arch::route()
 {
     std::string router = str_or_default(settings, id_router, defaultRouter);
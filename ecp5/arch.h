@@ -981,6 +981,7 @@ struct Arch : BaseArch<ArchRanges>
 
     bool pack() override;
     bool place() override;
+    void postLoadPlacement() override;
     bool route() override;
 
     // -------------------------------------------------
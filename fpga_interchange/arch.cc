@@ -843,6 +843,19 @@ bool Arch::place()
     return true;
 }
 
+void Arch::preLoadPlacement()
+{
+    getCtx()->check();
+    prepare_for_placement(getCtx());
+    getCtx()->check();
+}
+
+void Arch::postLoadPlacement()
+{
+    getCtx()->attrs[getCtx()->id("step")] = std::string("place");
+    archInfoToAttributes();
+}
+
 static void prepare_sites_for_routing(Context *ctx)
 {
     // Reset site routing and remove masked cell pins from previous router run
@@ -734,6 +734,8 @@ struct Arch : ArchAPI<ArchRanges>
 
     bool pack() final;
     bool place() final;
+    void preLoadPlacement() final;
+    void postLoadPlacement() final;
     bool route() final;
     // -------------------------------------------------
 
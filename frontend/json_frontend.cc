@@ -19,185 +19,602 @@
 
 #include "json_frontend.h"
 #include "frontend_base.h"
-#include "json11.hpp"
 #include "log.h"
 #include "nextpnr.h"
 
+#include <algorithm>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <limits>
 #include <streambuf>
 
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
 NEXTPNR_NAMESPACE_BEGIN
 
-using namespace json11;
+namespace {
+
+/*
+A compact, read-only JSON document. The input is memory mapped where possible and strings point straight into it
+(only strings containing escapes get a copy), and values live in a single flat array with the children of each array or
+object stored contiguously. This is several times smaller than a json11 tree, which allocates separately for every
+value, key and string, and means array elements can be indexed directly.
+*/
+struct JsonNode
+{
+    enum Kind : uint8_t
+    {
+        JSON_NULL,
+        JSON_BOOL,
+        JSON_NUMBER,
+        JSON_STRING,
+        JSON_ARRAY,
+        JSON_OBJECT
+    };
+    // key is only set for object members
+    const char *key = nullptr, *str = nullptr;
+    uint32_t key_len = 0, str_len = 0;
+    // numbers are stored as integers; is_int is false if the value had a fraction/exponent or didn't fit an int
+    int64_t int_val = 0;
+    // children of arrays/objects are nodes[first_child, first_child + size)
+    uint32_t first_child = 0, size = 0;
+    Kind kind = JSON_NULL;
+    bool is_int = false;
+
+    bool is_null() const { return kind == JSON_NULL; }
+    bool is_string() const { return kind == JSON_STRING; }
+    bool is_number() const { return kind == JSON_NUMBER; }
+    std::string key_str() const { return std::string(key, key_len); }
+    std::string string_value() const { return (kind == JSON_STRING) ? std::string(str, str_len) : std::string(); }
+    bool key_equals(const char *s) const { return key_len == std::strlen(s) && std::memcmp(key, s, key_len) == 0; }
+    // Same ordering as comparing the keys as std::strings
+    static int key_compare(const JsonNode &a, const JsonNode &b)
+    {
+        int cmp = std::memcmp(a.key, b.key, std::min(a.key_len, b.key_len));
+        if (cmp != 0)
+            return cmp;
+        return (a.key_len < b.key_len) ? -1 : ((a.key_len > b.key_len) ? 1 : 0);
+    }
+};
+
+struct JsonDocument
+{
+    std::vector<JsonNode> nodes;
+    // Storage for strings that needed unescaping, a deque so pointers into it stay valid
+    std::deque<std::string> unescaped;
+    uint32_t root = 0;
+
+    const JsonNode &child(const JsonNode &node, uint32_t i) const { return nodes.at(node.first_child + i); }
+
+    // Returns a null node if the key is missing, or node isn't an object
+    const JsonNode &get(const JsonNode &node, const char *key) const
+    {
+        static const JsonNode null_node;
+        if (node.kind != JsonNode::JSON_OBJECT)
+            return null_node;
+        for (uint32_t i = 0; i < node.size; i++) {
+            const JsonNode &c = child(node, i);
+            if (c.key_equals(key))
+                return c;
+        }
+        return null_node;
+    }
+
+    template <typename TFunc> void foreach_child(const JsonNode &node, TFunc Func) const
+    {
+        if (node.kind != JsonNode::JSON_ARRAY && node.kind != JsonNode::JSON_OBJECT)
+            return;
+        for (uint32_t i = 0; i < node.size; i++)
+            Func(child(node, i));
+    }
+};
+
+struct JsonParser
+{
+    JsonParser(const char *begin, const char *end, JsonDocument &doc, const std::string &filename)
+            : begin(begin), ptr(begin), end(end), doc(doc), filename(filename){};
+
+    const char *begin, *ptr, *end;
+    JsonDocument &doc;
+    const std::string &filename;
+    // Children of the containers currently being parsed, one list per nesting depth. Once a container is complete
+    // its children are appended to the document in one block, so they are contiguous.
+    std::vector<std::vector<JsonNode>> pending;
+
+    NPNR_NORETURN void error(const char *what)
+    {
+        int line = 1 + int(std::count(begin, ptr, '\n'));
+        log_error("Failed to parse JSON file '%s': %s on line %d.\n", filename.c_str(), what, line);
+    }
+
+    void skip_ws()
+    {
+        while (ptr < end) {
+            char c = *ptr;
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                ++ptr;
+            } else if (c == '/' && (ptr + 1) < end && ptr[1] == '/') {
+                while (ptr < end && *ptr != '\n')
+                    ++ptr;
+            } else if (c == '/' && (ptr + 1) < end && ptr[1] == '*') {
+                ptr += 2;
+                while ((ptr + 1) < end && !(ptr[0] == '*' && ptr[1] == '/'))
+                    ++ptr;
+                if ((ptr + 1) >= end)
+                    error("unterminated comment");
+                ptr += 2;
+            } else {
+                break;
+            }
+        }
+    }
+
+    void expect(char c)
+    {
+        skip_ws();
+        if (ptr >= end || *ptr != c) {
+            char msg[32];
+            snprintf(msg, sizeof(msg), "expected '%c'", c);
+            error(msg);
+        }
+        ++ptr;
+    }
+
+    static void append_utf8(std::string &out, uint32_t cp)
+    {
+        if (cp < 0x80) {
+            out += char(cp);
+        } else if (cp < 0x800) {
+            out += char(0xC0 | (cp >> 6));
+            out += char(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += char(0xE0 | (cp >> 12));
+            out += char(0x80 | ((cp >> 6) & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        } else {
+            out += char(0xF0 | (cp >> 18));
+            out += char(0x80 | ((cp >> 12) & 0x3F));
+            out += char(0x80 | ((cp >> 6) & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        }
+    }
+
+    uint32_t parse_hex4()
+    {
+        if (end - ptr < 4)
+            error("truncated \\u escape");
+        uint32_t cp = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = *ptr++;
+            cp <<= 4;
+            if (c >= '0' && c <= '9')
+                cp |= (c - '0');
+            else if (c >= 'a' && c <= 'f')
+                cp |= (c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                cp |= (c - 'A' + 10);
+            else
+                error("bad \\u escape");
+        }
+        return cp;
+    }
+
+    void parse_string(const char *&str, uint32_t &len)
+    {
+        expect('"');
+        const char *start = ptr;
+        while (ptr < end && *ptr != '"' && *ptr != '\\')
+            ++ptr;
+        if (ptr >= end)
+            error("unterminated string");
+        if (*ptr == '"') {
+            // The common case, no escapes so the string can point into the input
+            str = start;
+            len = uint32_t(ptr - start);
+            ++ptr;
+            return;
+        }
+        std::string s(start, ptr);
+        while (true) {
+            if (ptr >= end)
+                error("unterminated string");
+            char c = *ptr++;
+            if (c == '"')
+                break;
+            if (c != '\\') {
+                s += c;
+                continue;
+            }
+            if (ptr >= end)
+                error("unterminated string");
+            c = *ptr++;
+            switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                s += c;
+                break;
+            case 'b':
+                s += '\b';
+                break;
+            case 'f':
+                s += '\f';
+                break;
+            case 'n':
+                s += '\n';
+                break;
+            case 'r':
+                s += '\r';
+                break;
+            case 't':
+                s += '\t';
+                break;
+            case 'u': {
+                uint32_t cp = parse_hex4();
+                if (cp >= 0xD800 && cp <= 0xDBFF && (end - ptr) >= 6 && ptr[0] == '\\' && ptr[1] == 'u') {
+                    ptr += 2;
+                    uint32_t lo = parse_hex4();
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                }
+                append_utf8(s, cp);
+                break;
+            }
+            default:
+                error("bad escape sequence");
+            }
+        }
+        doc.unescaped.push_back(std::move(s));
+        str = doc.unescaped.back().data();
+        len = uint32_t(doc.unescaped.back().size());
+    }
+
+    void parse_number(JsonNode &node)
+    {
+        const char *start = ptr;
+        bool neg = false;
+        if (ptr < end && *ptr == '-') {
+            neg = true;
+            ++ptr;
+        }
+        bool overflow = false;
+        uint64_t mag = 0;
+        const char *digits = ptr;
+        while (ptr < end && *ptr >= '0' && *ptr <= '9') {
+            if (mag > (std::numeric_limits<uint64_t>::max() / 10 - 10))
+                overflow = true;
+            mag = mag * 10 + (*ptr - '0');
+            ++ptr;
+        }
+        if (ptr == digits)
+            error("bad number");
+        node.kind = JsonNode::JSON_NUMBER;
+        if (ptr < end && (*ptr == '.' || *ptr == 'e' || *ptr == 'E')) {
+            // Not an integer; these never appear in netlists other than as an error, so just keep the integer part
+            ++ptr;
+            while (ptr < end && ((*ptr >= '0' && *ptr <= '9') || *ptr == '+' || *ptr == '-' || *ptr == 'e' ||
+                                 *ptr == 'E' || *ptr == '.'))
+                ++ptr;
+            node.int_val = int64_t(std::strtod(std::string(start, ptr).c_str(), nullptr));
+            node.is_int = false;
+            return;
+        }
+        node.int_val = neg ? -int64_t(mag) : int64_t(mag);
+        node.is_int = !overflow && node.int_val >= std::numeric_limits<int>::min() &&
+                      node.int_val <= std::numeric_limits<int>::max();
+    }
+
+    void parse_literal(const char *lit)
+    {
+        size_t len = std::strlen(lit);
+        if (size_t(end - ptr) < len || std::memcmp(ptr, lit, len) != 0)
+            error("unexpected character");
+        ptr += len;
+    }
+
+    void finish_container(JsonNode &node, size_t depth)
+    {
+        auto &children = pending.at(depth);
+        if (node.kind == JsonNode::JSON_OBJECT) {
+            // Members are visited in sorted key order, keeping the last of any duplicates, like the std::map based
+            // json11 DOM this replaced. The order cells and nets are created in, and hence the result, depends on it.
+            std::stable_sort(children.begin(), children.end(), [](const JsonNode &a, const JsonNode &b) {
+                return JsonNode::key_compare(a, b) < 0;
+            });
+            auto last = std::unique(children.rbegin(), children.rend(), [](const JsonNode &a, const JsonNode &b) {
+                return JsonNode::key_compare(a, b) == 0;
+            });
+            children.erase(children.begin(), last.base());
+        }
+        node.first_child = uint32_t(doc.nodes.size());
+        node.size = uint32_t(children.size());
+        doc.nodes.insert(doc.nodes.end(), children.begin(), children.end());
+        children.clear();
+    }
+
+    void parse_value(JsonNode &node, size_t depth)
+    {
+        skip_ws();
+        if (ptr >= end)
+            error("unexpected end of file");
+        if (pending.size() <= depth)
+            pending.resize(depth + 1);
+        char c = *ptr;
+        if (c == '{') {
+            ++ptr;
+            node.kind = JsonNode::JSON_OBJECT;
+            skip_ws();
+            if (ptr < end && *ptr == '}') {
+                ++ptr;
+            } else {
+                while (true) {
+                    JsonNode child;
+                    skip_ws();
+                    parse_string(child.key, child.key_len);
+                    expect(':');
+                    parse_value(child, depth + 1);
+                    pending.at(depth).push_back(child);
+                    skip_ws();
+                    if (ptr < end && *ptr == ',') {
+                        ++ptr;
+                        continue;
+                    }
+                    expect('}');
+                    break;
+                }
+            }
+            finish_container(node, depth);
+        } else if (c == '[') {
+            ++ptr;
+            node.kind = JsonNode::JSON_ARRAY;
+            skip_ws();
+            if (ptr < end && *ptr == ']') {
+                ++ptr;
+            } else {
+                while (true) {
+                    JsonNode child;
+                    parse_value(child, depth + 1);
+                    pending.at(depth).push_back(child);
+                    skip_ws();
+                    if (ptr < end && *ptr == ',') {
+                        ++ptr;
+                        continue;
+                    }
+                    expect(']');
+                    break;
+                }
+            }
+            finish_container(node, depth);
+        } else if (c == '"') {
+            node.kind = JsonNode::JSON_STRING;
+            parse_string(node.str, node.str_len);
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            parse_number(node);
+        } else if (c == 't') {
+            parse_literal("true");
+            node.kind = JsonNode::JSON_BOOL;
+            node.int_val = 1;
+        } else if (c == 'f') {
+            parse_literal("false");
+            node.kind = JsonNode::JSON_BOOL;
+        } else if (c == 'n') {
+            parse_literal("null");
+            node.kind = JsonNode::JSON_NULL;
+        } else {
+            error("unexpected character");
+        }
+    }
+
+    void parse()
+    {
+        JsonNode root;
+        parse_value(root, 0);
+        skip_ws();
+        if (ptr != end)
+            error("trailing data after document");
+        doc.root = uint32_t(doc.nodes.size());
+        doc.nodes.push_back(root);
+        doc.nodes.shrink_to_fit();
+    }
+};
+
+// Current resident set size of the process, or -1 where it isn't known
+double get_rss_mib()
+{
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    long size_pages = 0, resident_pages = 0;
+    if (!(statm >> size_pages >> resident_pages))
+        return -1;
+    return double(resident_pages) * double(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+#else
+    return -1;
+#endif
+}
+
+} // namespace
 
 struct JsonFrontendImpl
 {
     // See specification in frontend_base.h
-    JsonFrontendImpl(Json &root) : root(root){};
-    Json &root;
-    typedef const Json &ModuleDataType;
-    typedef const Json &ModulePortDataType;
-    typedef const Json &CellDataType;
-    typedef const Json &NetnameDataType;
-    typedef const Json::array &BitVectorDataType;
+    JsonFrontendImpl(const JsonDocument &doc, const JsonNode &root) : doc(doc), root(root){};
+    const JsonDocument &doc;
+    const JsonNode &root;
+    typedef const JsonNode &ModuleDataType;
+    typedef const JsonNode &ModulePortDataType;
+    typedef const JsonNode &CellDataType;
+    typedef const JsonNode &NetnameDataType;
+    typedef const JsonNode &BitVectorDataType;
+
+    template <typename TFunc> void foreach_object_item(const JsonNode &obj, const char *key, TFunc Func) const
+    {
+        doc.foreach_child(doc.get(obj, key), [&](const JsonNode &item) { Func(item.key_str(), item); });
+    }
 
     template <typename TFunc> void foreach_module(TFunc Func) const
     {
-        for (const auto &mod : root.object_items())
-            Func(mod.first, mod.second);
+        doc.foreach_child(root, [&](const JsonNode &mod) { Func(mod.key_str(), mod); });
     }
 
     template <typename TFunc> void foreach_port(ModuleDataType &mod, TFunc Func) const
     {
-        const auto &ports = mod["ports"];
-        if (ports.is_null())
-            return;
-        for (const auto &port : ports.object_items())
-            Func(port.first, port.second);
+        foreach_object_item(mod, "ports", Func);
     }
 
     template <typename TFunc> void foreach_cell(ModuleDataType &mod, TFunc Func) const
     {
-        const auto &cells = mod["cells"];
-        if (cells.is_null())
-            return;
-        for (const auto &cell : cells.object_items())
-            Func(cell.first, cell.second);
+        foreach_object_item(mod, "cells", Func);
     }
 
     template <typename TFunc> void foreach_netname(ModuleDataType &mod, TFunc Func) const
     {
-        const auto &netnames = mod["netnames"];
-        if (netnames.is_null())
-            return;
-        for (const auto &netname : netnames.object_items())
-            Func(netname.first, netname.second);
+        foreach_object_item(mod, "netnames", Func);
     }
 
-    PortType lookup_portdir(const std::string &dir) const
+    PortType lookup_portdir(const JsonNode &dir) const
     {
-        if (dir == "input")
+        std::string s = dir.string_value();
+        if (s == "input")
             return PORT_IN;
-        else if (dir == "inout")
+        else if (s == "inout")
             return PORT_INOUT;
-        else if (dir == "output")
+        else if (s == "output")
             return PORT_OUT;
         else
             NPNR_ASSERT_FALSE("invalid json port direction");
     }
 
-    PortType get_port_dir(ModulePortDataType &port) const { return lookup_portdir(port["direction"].string_value()); }
+    PortType get_port_dir(ModulePortDataType &port) const { return lookup_portdir(doc.get(port, "direction")); }
 
-    int get_array_offset(const Json &obj) const
+    int get_array_offset(const JsonNode &obj) const
     {
-        auto offset = obj["offset"];
-        return offset.is_null() ? 0 : offset.int_value();
+        auto &offset = doc.get(obj, "offset");
+        return offset.is_null() ? 0 : int(offset.int_val);
     }
 
-    bool is_array_upto(const Json &obj) const
+    bool is_array_upto(const JsonNode &obj) const
     {
-        auto upto = obj["upto"];
-        return upto.is_null() ? false : bool(upto.int_value());
+        auto &upto = doc.get(obj, "upto");
+        return upto.is_null() ? false : bool(upto.int_val);
     }
 
-    BitVectorDataType &get_port_bits(ModulePortDataType &port) const { return port["bits"].array_items(); }
+    BitVectorDataType &get_port_bits(ModulePortDataType &port) const { return doc.get(port, "bits"); }
 
-    const std::string &get_cell_type(CellDataType &cell) const { return cell["type"].string_value(); }
+    std::string get_cell_type(CellDataType &cell) const { return doc.get(cell, "type").string_value(); }
 
-    Property parse_property(const Json &val) const
+    Property parse_property(const JsonNode &val) const
     {
         if (val.is_number()) {
-            if (val.int_value() != val.number_value())
+            if (!val.is_int)
                 log_error("Found an out-of-range integer parameter in the JSON file.\n"
                           "Please regenerate the input file with an up-to-date version of yosys.\n");
-            return Property(val.int_value(), 32);
+            return Property(val.int_val, 32);
         } else {
             return Property::from_string(val.string_value());
         }
     }
 
-    template <typename TFunc> void foreach_attr(const Json &obj, TFunc Func) const
+    template <typename TFunc> void foreach_attr(const JsonNode &obj, TFunc Func) const
     {
-        const auto &attrs = obj["attributes"];
-        if (attrs.is_null())
-            return;
-        for (const auto &attr : attrs.object_items()) {
-            Func(attr.first, parse_property(attr.second));
-        }
+        foreach_object_item(obj, "attributes",
+                            [&](const std::string &name, const JsonNode &attr) { Func(name, parse_property(attr)); });
     }
 
-    template <typename TFunc> void foreach_param(const Json &obj, TFunc Func) const
+    template <typename TFunc> void foreach_param(const JsonNode &obj, TFunc Func) const
     {
-        const auto &params = obj["parameters"];
-        if (params.is_null())
-            return;
-        for (const auto &param : params.object_items()) {
-            Func(param.first, parse_property(param.second));
-        }
+        foreach_object_item(obj, "parameters",
+                            [&](const std::string &name, const JsonNode &param) { Func(name, parse_property(param)); });
     }
 
-    template <typename TFunc> void foreach_setting(const Json &obj, TFunc Func) const
+    template <typename TFunc> void foreach_setting(const JsonNode &obj, TFunc Func) const
     {
-        const auto &settings = obj["settings"];
-        if (settings.is_null())
-            return;
-        for (const auto &setting : settings.object_items()) {
-            Func(setting.first, parse_property(setting.second));
-        }
+        foreach_object_item(obj, "settings", [&](const std::string &name, const JsonNode &setting) {
+            Func(name, parse_property(setting));
+        });
     }
 
     template <typename TFunc> void foreach_port_dir(CellDataType &cell, TFunc Func) const
     {
-        for (const auto &pdir : cell["port_directions"].object_items())
-            Func(pdir.first, lookup_portdir(pdir.second.string_value()));
+        foreach_object_item(cell, "port_directions",
+                            [&](const std::string &name, const JsonNode &dir) { Func(name, lookup_portdir(dir)); });
     }
 
     template <typename TFunc> void foreach_port_conn(CellDataType &cell, TFunc Func) const
     {
-        for (const auto &pconn : cell["connections"].object_items())
-            Func(pconn.first, pconn.second.array_items());
+        foreach_object_item(cell, "connections", Func);
     }
 
-    BitVectorDataType &get_net_bits(NetnameDataType &net) const { return net["bits"].array_items(); }
+    BitVectorDataType &get_net_bits(NetnameDataType &net) const { return doc.get(net, "bits"); }
 
-    int get_vector_length(BitVectorDataType &bits) const { return int(bits.size()); }
+    int get_vector_length(BitVectorDataType &bits) const { return int(bits.size); }
 
     bool is_vector_bit_constant(BitVectorDataType &bits, int i) const
     {
-        NPNR_ASSERT(i < int(bits.size()));
-        return bits[i].is_string();
+        NPNR_ASSERT(i < int(bits.size));
+        return doc.child(bits, i).is_string();
     }
 
     char get_vector_bit_constval(BitVectorDataType &bits, int i) const
     {
-        auto s = bits.at(i).string_value();
-        NPNR_ASSERT(s.size() == 1);
-        return s.at(0);
+        auto &bit = doc.child(bits, i);
+        NPNR_ASSERT(bit.is_string() && bit.str_len == 1);
+        return bit.str[0];
     }
 
     int get_vector_bit_signal(BitVectorDataType &bits, int i) const
     {
-        NPNR_ASSERT(bits.at(i).is_number());
-        return bits.at(i).int_value();
+        auto &bit = doc.child(bits, i);
+        NPNR_ASSERT(bit.is_number());
+        return int(bit.int_val);
     }
 };
 
-bool parse_json(std::istream &in, const std::string &filename, Context *ctx)
+bool parse_json(std::istream &in, const std::string &filename, Context *ctx, bool map_file)
 {
-    Json root;
-    {
-        if (!in)
-            log_error("Failed to open JSON file '%s'.\n", filename.c_str());
-        std::string json_str((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
-        std::string error;
-        root = Json::parse(json_str, error, JsonParse::COMMENTS);
-        if (root.is_null())
-            log_error("Failed to parse JSON file '%s': %s.\n", filename.c_str(), error.c_str());
-        root = root["modules"];
-        if (root.is_null())
-            log_error("JSON file '%s' doesn't look like a netlist (doesn't contain \"modules\" key)\n",
-                      filename.c_str());
-    }
-    GenericFrontend<JsonFrontendImpl>(ctx, JsonFrontendImpl(root), /*split_io=*/true)();
+    auto start = std::chrono::high_resolution_clock::now();
+    double rss_before = get_rss_mib();
+    if (!in)
+        log_error("Failed to open JSON file '%s'.\n", filename.c_str());
+    // Memory map the file if the caller allows it, so the only extra memory needed is the document structure itself
+    boost::iostreams::mapped_file_source mapped;
+    std::string buffer;
+    const char *data_begin = nullptr, *data_end = nullptr;
+    if (map_file) {
+        try {
+            mapped.open(filename);
+        } catch (std::exception &) {
+            // fall back to reading the stream below
+        }
+    }
+    if (mapped.is_open()) {
+        data_begin = mapped.data();
+        data_end = mapped.data() + mapped.size();
+    } else {
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_begin = buffer.data();
+        data_end = buffer.data() + buffer.size();
+    }
+
+    JsonDocument doc;
+    JsonParser(data_begin, data_end, doc, filename).parse();
+    const JsonNode &modules = doc.get(doc.nodes.at(doc.root), "modules");
+    if (modules.is_null())
+        log_error("JSON file '%s' doesn't look like a netlist (doesn't contain \"modules\" key)\n", filename.c_str());
+    GenericFrontend<JsonFrontendImpl>(ctx, JsonFrontendImpl(doc, modules), /*split_io=*/true)();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    // Measured while the parse tree is still alive, so this covers it as well as the netlist it was turned into
+    double rss_after = get_rss_mib();
+    if (rss_before >= 0 && rss_after >= 0)
+        log_info("Loaded JSON netlist '%s' in %.02fs (RSS %+.1f MiB).\n", filename.c_str(),
+                 std::chrono::duration<float>(end - start).count(), rss_after - rss_before);
+    else
+        log_info("Loaded JSON netlist '%s' in %.02fs.\n", filename.c_str(),
+                 std::chrono::duration<float>(end - start).count());
     return true;
 }
 
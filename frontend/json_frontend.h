@@ -21,6 +21,8 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
-bool parse_json(std::istream &in, const std::string &filename, Context *ctx);
+// If map_file is set, the file named by filename is memory mapped and parsed instead of reading from in, which must
+// then be a freshly opened stream of that same file. Reading falls back to in if mapping fails.
+bool parse_json(std::istream &in, const std::string &filename, Context *ctx, bool map_file = false);
 
 NEXTPNR_NAMESPACE_END
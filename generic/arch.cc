@@ -31,9 +31,11 @@ NEXTPNR_NAMESPACE_BEGIN
 
 WireId Arch::addWire(IdStringList name, IdString type, int x, int y)
 {
-    NPNR_ASSERT(wire_by_name.count(name) == 0);
     WireId wire(wires.size());
-    wire_by_name[name] = wire;
+    if (wire_names_valid) {
+        NPNR_ASSERT(wire_by_name.count(name) == 0);
+        wire_by_name[name] = wire;
+    }
     wires.emplace_back();
     WireInfo &wi = wires.back();
     wi.name = name;
@@ -69,9 +71,11 @@ WireId Arch::addWireAsBelInout(BelId bel, IdString name)
 
 PipId Arch::addPip(IdStringList name, IdString type, WireId srcWire, WireId dstWire, delay_t delay, Loc loc)
 {
-    NPNR_ASSERT(pip_by_name.count(name) == 0);
     PipId pip(pips.size());
-    pip_by_name[name] = pip;
+    if (pip_names_valid) {
+        NPNR_ASSERT(pip_by_name.count(name) == 0);
+        pip_by_name[name] = pip;
+    }
     pips.emplace_back();
     PipInfo &pi = pips.back();
     pi.name = name;
@@ -98,10 +102,12 @@ PipId Arch::addPip(IdStringList name, IdString type, WireId srcWire, WireId dstW
 
 BelId Arch::addBel(IdStringList name, IdString type, Loc loc, bool gb, bool hidden)
 {
-    NPNR_ASSERT(bel_by_name.count(name) == 0);
     NPNR_ASSERT(bel_by_loc.count(loc) == 0);
     BelId bel(bels.size());
-    bel_by_name[name] = bel;
+    if (bel_names_valid) {
+        NPNR_ASSERT(bel_by_name.count(name) == 0);
+        bel_by_name[name] = bel;
+    }
     bels.emplace_back();
     BelInfo &bi = bels.back();
     bi.name = name;
@@ -270,12 +276,49 @@ void IdString::initialize_arch(const BaseCtx *ctx) {}
 
 // ---------------------------------------------------------------
 
+namespace {
+template <typename TId, typename TInfo>
+void build_name_map(const Context *ctx, dict<IdStringList, TId> &map, bool &valid, const std::vector<TInfo> &items,
+                    const char *kind)
+{
+    if (valid)
+        return;
+    map.reserve(items.size());
+    for (int32_t i = 0; i < int32_t(items.size()); i++) {
+        if (!map.emplace(items.at(i).name, TId(i)).second)
+            log_error("Duplicate %s name '%s'.\n", kind, items.at(i).name.str(ctx).c_str());
+    }
+    valid = true;
+}
+} // namespace
+
+const dict<IdStringList, WireId> &Arch::wire_name_map() const
+{
+    build_name_map(getCtx(), wire_by_name, wire_names_valid, wires, "wire");
+    return wire_by_name;
+}
+
+const dict<IdStringList, PipId> &Arch::pip_name_map() const
+{
+    build_name_map(getCtx(), pip_by_name, pip_names_valid, pips, "pip");
+    return pip_by_name;
+}
+
+const dict<IdStringList, BelId> &Arch::bel_name_map() const
+{
+    build_name_map(getCtx(), bel_by_name, bel_names_valid, bels, "bel");
+    return bel_by_name;
+}
+
+// ---------------------------------------------------------------
+
 BelId Arch::getBelByName(IdStringList name) const
 {
     if (name.size() == 0)
         return BelId();
-    auto fnd = bel_by_name.find(name);
-    if (fnd == bel_by_name.end())
+    auto &names = bel_name_map();
+    auto fnd = names.find(name);
+    if (fnd == names.end())
         NPNR_ASSERT_FALSE_STR("no bel named " + name.str(getCtx()));
     return fnd->second;
 }
@@ -373,8 +416,9 @@ WireId Arch::getWireByName(IdStringList name) const
 {
     if (name.size() == 0)
         return WireId();
-    auto fnd = wire_by_name.find(name);
-    if (fnd == wire_by_name.end())
+    auto &names = wire_name_map();
+    auto fnd = names.find(name);
+    if (fnd == names.end())
         NPNR_ASSERT_FALSE_STR("no wire named " + name.str(getCtx()));
     return fnd->second;
 }
@@ -435,8 +479,9 @@ PipId Arch::getPipByName(IdStringList name) const
 {
     if (name.size() == 0)
         return PipId();
-    auto fnd = pip_by_name.find(name);
-    if (fnd == pip_by_name.end())
+    auto &names = pip_name_map();
+    auto fnd = names.find(name);
+    if (fnd == names.end())
         NPNR_ASSERT_FALSE_STR("no pip named " + name.str(getCtx()));
     return fnd->second;
 }
@@ -632,6 +677,20 @@ bool Arch::place()
     }
 }
 
+void Arch::preLoadPlacement()
+{
+    if (uarch)
+        uarch->prePlace();
+}
+
+void Arch::postLoadPlacement()
+{
+    if (uarch)
+        uarch->postPlace();
+    getCtx()->settings[getCtx()->id("place")] = 1;
+    archInfoToAttributes();
+}
+
 bool Arch::route()
 {
     if (uarch)
@@ -178,9 +178,16 @@ struct Arch : BaseArch<ArchRanges>
     const PipInfo &pip_info(PipId pip) const { return pips.at(pip.index); }
     const BelInfo &bel_info(BelId bel) const { return bels.at(bel.index); }
 
-    dict<IdStringList, WireId> wire_by_name;
-    dict<IdStringList, PipId> pip_by_name;
-    dict<IdStringList, BelId> bel_by_name;
+    // Name lookup maps, kept up to date by addWire, addPip and addBel, which also reject duplicate names. readDevice
+    // doesn't build them, as for large devices they are a big part of load time and memory, and they are then only
+    // built (and checked for duplicates) on the first lookup by name.
+    const dict<IdStringList, WireId> &wire_name_map() const;
+    const dict<IdStringList, PipId> &pip_name_map() const;
+    const dict<IdStringList, BelId> &bel_name_map() const;
+    mutable dict<IdStringList, WireId> wire_by_name;
+    mutable dict<IdStringList, PipId> pip_by_name;
+    mutable dict<IdStringList, BelId> bel_by_name;
+    mutable bool wire_names_valid = true, pip_names_valid = true, bel_names_valid = true;
 
     dict<Loc, BelId> bel_by_loc;
     std::vector<std::vector<std::vector<BelId>>> bels_by_tile;
@@ -232,6 +239,19 @@ struct Arch : BaseArch<ArchRanges>
     void clearCellBelPinMap(IdString cell, IdString cell_pin);
     void addCellBelPinMapping(IdString cell, IdString cell_pin, IdString bel_pin);
 
+    // Bulk device format: a compact binary snapshot of a fully built device (bels, wires, pips, their attributes and
+    // any uarch state), which readDevice memory-maps and loads in one pass instead of the addWire/addPip/addBel calls
+    // that built it. Groups and decals are GUI-only and not included.
+    void writeDevice(const std::string &filename) const;
+    void readDevice(const std::string &filename);
+    // Name of the viaduct uarch in use, checked against the uarch that wrote a device file
+    std::string uarch_name;
+    // Device file for ViaductAPI::init to load in place of building the device
+    std::string device_file;
+    // Set by readDevice, along with any state saved by ViaductAPI::saveDeviceState
+    bool device_loaded = false;
+    std::vector<int32_t> uarch_device_state;
+
     // ---------------------------------------------------------------
     // Common Arch API. Every arch must provide the following methods.
 
@@ -285,6 +305,8 @@ struct Arch : BaseArch<ArchRanges>
     DelayQuad getWireDelay(WireId wire) const override { return DelayQuad(0); }
     linear_range<WireId> getWires() const override;
     const std::vector<BelPin> &getWireBelPins(WireId wire) const override;
+    int getFlatWireCount() const override { return int(wires.size()); }
+    int getFlatWireIndex(WireId wire) const override { return wire.index; }
 
     PipId getPipByName(IdStringList name) const override;
     IdStringList getPipName(PipId pip) const override;
@@ -329,6 +351,8 @@ struct Arch : BaseArch<ArchRanges>
 
     bool pack() override;
     bool place() override;
+    void preLoadPlacement() override;
+    void postLoadPlacement() override;
     bool route() override;
 
     std::vector<IdString> getCellTypes() const override
@@ -0,0 +1,419 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include "log.h"
+#include "nextpnr.h"
+#include "viaduct_api.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Bulk device file layout. Everything is a 32-bit word in the byte order of the host that wrote it; files are not
+// portable between hosts of different endianness, which the magic number detects:
+//   header: magic[2], version, number of strings, string data bytes, number of wires, pips, bels,
+//           body words, uarch state words
+//   string table: (number of strings + 1) offsets into the string data, then the string data padded to a word
+//   body: chip name, uarch name (string indices, -1 for none), LUT K, delay scale and offset (as doubles),
+//         delay epsilon and ripup penalty (as floats), then each wire, pip and bel record in index order
+//   uarch state: as returned by ViaductAPI::saveDeviceState
+// Names are a count followed by that many string indices. Strings used as names, types or attribute keys are turned
+// into IdStrings once each, when first used; attribute values are only ever read as plain strings, so they never enter
+// the IdString database.
+
+namespace {
+const int32_t device_magic[2] = {0x524e504e /* NPNR */, 0x56454447 /* GDEV */};
+const int32_t device_version = 1;
+const int header_words = 10;
+
+struct DeviceWriter
+{
+    const Context *ctx;
+    std::vector<int32_t> body;
+    std::vector<std::string> strings;
+    dict<std::string, int32_t> string_index;
+    std::vector<int32_t> id_index; // IdString index to string index, or -1
+
+    explicit DeviceWriter(const Context *ctx) : ctx(ctx){};
+
+    int32_t add_str(const std::string &s)
+    {
+        auto fnd = string_index.find(s);
+        if (fnd != string_index.end())
+            return fnd->second;
+        int32_t idx = int32_t(strings.size());
+        strings.push_back(s);
+        string_index.emplace(s, idx);
+        return idx;
+    }
+
+    void str(const std::string &s) { body.push_back(add_str(s)); }
+
+    void id(IdString i)
+    {
+        if (i.index >= int(id_index.size()))
+            id_index.resize(i.index + 1, -1);
+        if (id_index.at(i.index) == -1)
+            id_index.at(i.index) = add_str(i.str(ctx));
+        body.push_back(id_index.at(i.index));
+    }
+
+    void word(int32_t w) { body.push_back(w); }
+
+    void f32(float f)
+    {
+        int32_t w;
+        memcpy(&w, &f, sizeof(w));
+        body.push_back(w);
+    }
+
+    void f64(double d)
+    {
+        int32_t w[2];
+        memcpy(w, &d, sizeof(w));
+        body.push_back(w[0]);
+        body.push_back(w[1]);
+    }
+
+    void name(const IdStringList &n)
+    {
+        word(int32_t(n.size()));
+        for (IdString i : n)
+            id(i);
+    }
+
+    void attrs(const std::map<IdString, std::string> &a)
+    {
+        word(int32_t(a.size()));
+        for (auto &kv : a) {
+            id(kv.first);
+            str(kv.second);
+        }
+    }
+};
+
+struct DeviceReader
+{
+    Context *ctx;
+    std::string filename;
+    const int32_t *cursor, *end;
+    int32_t num_strings;
+    const int32_t *string_offsets;
+    const char *string_data;
+    std::vector<IdString> ids;
+    std::vector<bool> id_valid;
+
+    int32_t word()
+    {
+        if (cursor >= end)
+            log_error("Device file '%s' is truncated.\n", filename.c_str());
+        return *(cursor++);
+    }
+
+    int32_t index(int32_t limit, const char *what)
+    {
+        int32_t i = word();
+        if (i < 0 || i >= limit)
+            log_error("Device file '%s' has an invalid %s index %d.\n", filename.c_str(), what, i);
+        return i;
+    }
+
+    std::string get_str(int32_t i) const
+    {
+        return std::string(string_data + string_offsets[i], string_offsets[i + 1] - string_offsets[i]);
+    }
+
+    std::string str() { return get_str(index(num_strings, "string")); }
+
+    IdString id()
+    {
+        int32_t i = index(num_strings, "string");
+        if (!id_valid.at(i)) {
+            ids.at(i) = ctx->id(get_str(i));
+            id_valid.at(i) = true;
+        }
+        return ids.at(i);
+    }
+
+    float f32()
+    {
+        int32_t w = word();
+        float f;
+        memcpy(&f, &w, sizeof(f));
+        return f;
+    }
+
+    double f64()
+    {
+        int32_t w[2];
+        w[0] = word();
+        w[1] = word();
+        double d;
+        memcpy(&d, w, sizeof(d));
+        return d;
+    }
+
+    IdStringList name()
+    {
+        int32_t count = word();
+        if (count < 0 || count > (end - cursor))
+            log_error("Device file '%s' has an invalid name.\n", filename.c_str());
+        size_t size = count;
+        IdStringList result(size);
+        for (size_t i = 0; i < size; i++)
+            result.ids[i] = id();
+        return result;
+    }
+
+    void attrs(std::map<IdString, std::string> &a)
+    {
+        int32_t count = word();
+        for (int32_t i = 0; i < count; i++) {
+            IdString key = id();
+            a[key] = str();
+        }
+    }
+};
+} // namespace
+
+void Arch::writeDevice(const std::string &filename) const
+{
+    DeviceWriter w(getCtx());
+    w.str(chipName);
+    w.word(uarch_name.empty() ? -1 : w.add_str(uarch_name));
+    w.word(args.K);
+    w.f64(args.delayScale);
+    w.f64(args.delayOffset);
+    w.f32(delay_epsilon);
+    w.f32(ripup_penalty);
+    for (auto &wi : wires) {
+        w.name(wi.name);
+        w.id(wi.type);
+        w.word(wi.x);
+        w.word(wi.y);
+        w.attrs(wi.attrs);
+        w.word(int32_t(wi.bel_pins.size()));
+        for (auto &bp : wi.bel_pins) {
+            w.word(bp.bel.index);
+            w.id(bp.pin);
+        }
+    }
+    for (auto &pi : pips) {
+        w.name(pi.name);
+        w.id(pi.type);
+        w.word(pi.srcWire.index);
+        w.word(pi.dstWire.index);
+        w.f32(pi.delay);
+        w.word(pi.loc.x);
+        w.word(pi.loc.y);
+        w.word(pi.loc.z);
+        w.attrs(pi.attrs);
+    }
+    for (auto &bi : bels) {
+        w.name(bi.name);
+        w.id(bi.type);
+        w.word(bi.x);
+        w.word(bi.y);
+        w.word(bi.z);
+        w.word((bi.gb ? 1 : 0) | (bi.hidden ? 2 : 0));
+        w.attrs(bi.attrs);
+        w.word(int32_t(bi.pins.size()));
+        for (auto &pin : bi.pins) {
+            w.id(pin.second.name);
+            w.word(pin.second.wire.index);
+            w.word(int32_t(pin.second.type));
+        }
+    }
+
+    std::vector<int32_t> uarch_state;
+    if (uarch && !uarch->saveDeviceState(uarch_state))
+        log_error("The '%s' uarch doesn't support saving the device.\n", uarch_name.c_str());
+
+    std::vector<int32_t> offsets;
+    std::string string_data;
+    for (auto &s : w.strings) {
+        offsets.push_back(int32_t(string_data.size()));
+        string_data += s;
+    }
+    offsets.push_back(int32_t(string_data.size()));
+    string_data.resize((string_data.size() + 3) & ~size_t(3), '\0');
+
+    std::vector<int32_t> header{device_magic[0],
+                                device_magic[1],
+                                device_version,
+                                int32_t(w.strings.size()),
+                                int32_t(string_data.size()),
+                                int32_t(wires.size()),
+                                int32_t(pips.size()),
+                                int32_t(bels.size()),
+                                int32_t(w.body.size()),
+                                int32_t(uarch_state.size())};
+    NPNR_ASSERT(int(header.size()) == header_words);
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out)
+        log_error("Failed to open device file '%s' for writing.\n", filename.c_str());
+    auto write_words = [&](const std::vector<int32_t> &v) {
+        out.write(reinterpret_cast<const char *>(v.data()), v.size() * sizeof(int32_t));
+    };
+    write_words(header);
+    write_words(offsets);
+    out.write(string_data.data(), string_data.size());
+    write_words(w.body);
+    write_words(uarch_state);
+    if (!out)
+        log_error("Failed to write device file '%s'.\n", filename.c_str());
+    log_info("Wrote device with %d wires, %d pips and %d bels to '%s' (%.1f MiB).\n", int(wires.size()),
+             int(pips.size()), int(bels.size()), filename.c_str(), double(out.tellp()) / (1024 * 1024));
+}
+
+void Arch::readDevice(const std::string &filename)
+{
+    if (!wires.empty() || !pips.empty() || !bels.empty())
+        log_error("A device can only be loaded into an empty context.\n");
+    auto start = std::chrono::high_resolution_clock::now();
+
+    boost::iostreams::mapped_file_source blob;
+    try {
+        blob.open(filename);
+    } catch (...) {
+        log_error("Unable to open device file '%s'.\n", filename.c_str());
+    }
+    if (!blob.is_open() || blob.size() < header_words * sizeof(int32_t))
+        log_error("Unable to read device file '%s'.\n", filename.c_str());
+    const int32_t *data = reinterpret_cast<const int32_t *>(blob.data());
+    const int32_t *data_end = data + blob.size() / sizeof(int32_t);
+    auto bswap = [](int32_t w) {
+        uint32_t u = uint32_t(w);
+        return int32_t((u >> 24) | ((u >> 8) & 0xff00U) | ((u << 8) & 0xff0000U) | (u << 24));
+    };
+    if (data[0] == bswap(device_magic[0]) && data[1] == bswap(device_magic[1]))
+        log_error("Device file '%s' was written on a host with a different byte order.\n", filename.c_str());
+    if (data[0] != device_magic[0] || data[1] != device_magic[1])
+        log_error("'%s' is not a nextpnr-generic device file.\n", filename.c_str());
+    if (data[2] != device_version)
+        log_error("Device file '%s' has version %d, expected %d.\n", filename.c_str(), data[2], device_version);
+
+    DeviceReader r;
+    r.ctx = getCtx();
+    r.filename = filename;
+    r.num_strings = data[3];
+    int64_t string_bytes = data[4], num_wires = data[5], num_pips = data[6], num_bels = data[7];
+    int64_t body_words = data[8], uarch_words = data[9];
+    int64_t total_words = header_words + (r.num_strings + 1) + string_bytes / 4 + body_words + uarch_words;
+    if (r.num_strings < 0 || string_bytes < 0 || (string_bytes % 4) != 0 || body_words < 0 || uarch_words < 0 ||
+        total_words > (data_end - data))
+        log_error("Device file '%s' is truncated or corrupt.\n", filename.c_str());
+    r.string_offsets = data + header_words;
+    r.string_data = reinterpret_cast<const char *>(r.string_offsets + r.num_strings + 1);
+    for (int32_t i = 0; i <= r.num_strings; i++)
+        if (r.string_offsets[i] < 0 || r.string_offsets[i] > string_bytes ||
+            (i > 0 && r.string_offsets[i] < r.string_offsets[i - 1]))
+            log_error("Device file '%s' has a corrupt string table.\n", filename.c_str());
+    r.ids.resize(r.num_strings);
+    r.id_valid.resize(r.num_strings, false);
+    r.cursor = reinterpret_cast<const int32_t *>(r.string_data + string_bytes);
+    r.end = r.cursor + body_words;
+
+    chipName = r.str();
+    std::string file_uarch;
+    if (r.word() != -1) {
+        r.cursor--;
+        file_uarch = r.str();
+    }
+    if (file_uarch != uarch_name)
+        log_error("Device file '%s' was written for uarch '%s', but uarch '%s' is in use.\n", filename.c_str(),
+                  file_uarch.empty() ? "<none>" : file_uarch.c_str(),
+                  uarch_name.empty() ? "<none>" : uarch_name.c_str());
+    args.K = r.word();
+    args.delayScale = r.f64();
+    args.delayOffset = r.f64();
+    delay_epsilon = r.f32();
+    ripup_penalty = r.f32();
+
+    wire_names_valid = pip_names_valid = bel_names_valid = false;
+    wire_by_name.clear();
+    pip_by_name.clear();
+    bel_by_name.clear();
+    wires.reserve(num_wires);
+    pips.reserve(num_pips);
+    bels.reserve(num_bels);
+    for (int64_t i = 0; i < num_wires; i++) {
+        IdStringList name = r.name();
+        IdString type = r.id();
+        int x = r.word();
+        int y = r.word();
+        WireId wire = addWire(name, type, x, y);
+        auto &wi = wire_info(wire);
+        r.attrs(wi.attrs);
+        int32_t num_bel_pins = r.word();
+        for (int32_t j = 0; j < num_bel_pins; j++) {
+            BelId bel(r.index(num_bels, "bel"));
+            wi.bel_pins.push_back(BelPin{bel, r.id()});
+        }
+    }
+    for (int64_t i = 0; i < num_pips; i++) {
+        IdStringList name = r.name();
+        IdString type = r.id();
+        WireId src(r.index(num_wires, "wire"));
+        WireId dst(r.index(num_wires, "wire"));
+        delay_t delay = r.f32();
+        Loc loc;
+        loc.x = r.word();
+        loc.y = r.word();
+        loc.z = r.word();
+        PipId pip = addPip(name, type, src, dst, delay, loc);
+        r.attrs(pip_info(pip).attrs);
+    }
+    for (int64_t i = 0; i < num_bels; i++) {
+        IdStringList name = r.name();
+        IdString type = r.id();
+        Loc loc;
+        loc.x = r.word();
+        loc.y = r.word();
+        loc.z = r.word();
+        int32_t flags = r.word();
+        BelId bel = addBel(name, type, loc, (flags & 1) != 0, (flags & 2) != 0);
+        auto &bi = bel_info(bel);
+        r.attrs(bi.attrs);
+        int32_t num_pins = r.word();
+        for (int32_t j = 0; j < num_pins; j++) {
+            IdString pin_name = r.id();
+            int32_t wire_idx = r.word();
+            if (wire_idx < -1 || wire_idx >= num_wires)
+                log_error("Device file '%s' has an invalid wire index %d.\n", filename.c_str(), wire_idx);
+            PinInfo &pin = bi.pins[pin_name];
+            pin.name = pin_name;
+            pin.wire = WireId(wire_idx);
+            pin.type = PortType(r.word());
+        }
+    }
+    if (r.cursor != r.end)
+        log_error("Device file '%s' has unexpected trailing data.\n", filename.c_str());
+    uarch_device_state.assign(r.end, r.end + uarch_words);
+    device_loaded = true;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    log_info("Loaded device with %d wires, %d pips and %d bels from '%s' in %.02fs.\n", int(num_wires), int(num_pips),
+             int(num_bels), filename.c_str(), std::chrono::duration<double>(end - start).count());
+}
+
+NEXTPNR_NAMESPACE_END
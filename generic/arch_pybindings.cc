@@ -173,6 +173,11 @@ void arch_wrap_python(py::module &m)
                     conv_from_str<IdString>>::def_wrap(ctx_cls, "addCellBelPinMapping", "cell"_a, "cell_pin"_a,
                                                        "bel_pin"_a);
 
+    fn_wrapper_1a_v<Context, decltype(&Context::writeDevice), &Context::writeDevice,
+                    pass_through<std::string>>::def_wrap(ctx_cls, "writeDevice", "filename"_a);
+    fn_wrapper_1a_v<Context, decltype(&Context::readDevice), &Context::readDevice,
+                    pass_through<std::string>>::def_wrap(ctx_cls, "readDevice", "filename"_a);
+
     WRAP_RANGE(m, Bel, conv_to_str<BelId>);
     WRAP_RANGE(m, Wire, conv_to_str<WireId>);
     WRAP_RANGE(m, AllPip, conv_to_str<PipId>);
@@ -50,6 +50,9 @@ po::options_description GenericCommandHandler::getArchOptions()
     specific.add_options()("uarch", po::value<std::string>(), uarch_help.c_str());
     specific.add_options()("no-iobs", "disable automatic IO buffer insertion");
     specific.add_options()("vopt,o", po::value<std::vector<std::string>>(), "options to pass to the viaduct uarch");
+    specific.add_options()("read-device", po::value<std::string>(),
+                           "load the device from a file made by --write-device");
+    specific.add_options()("write-device", po::value<std::string>(), "save the device built by the uarch to a file");
 
     return specific;
 }
@@ -65,6 +68,8 @@ std::unique_ptr<Context> GenericCommandHandler::createContext(dict<std::string,
             log_error("Unsupported architecture '%s'.\n", arch_name.c_str());
     }
     auto ctx = std::unique_ptr<Context>(new Context(chipArgs));
+    if (vm.count("read-device") && vm.count("write-device"))
+        log_error("--read-device and --write-device can't be used together.\n");
     if (vm.count("no-iobs"))
         ctx->settings[ctx->id("disable_iobs")] = Property::State::S1;
     if (vm.count("uarch")) {
@@ -86,9 +91,18 @@ std::unique_ptr<Context> GenericCommandHandler::createContext(dict<std::string,
             log_error("Unknown viaduct uarch '%s'; available options: '%s'\n", uarch_name.c_str(), all_uarches.c_str());
         }
         ctx->uarch = std::move(uarch);
+        ctx->uarch_name = uarch_name;
         if (vm.count("gui"))
             ctx->uarch->with_gui = true;
+        if (vm.count("read-device"))
+            ctx->device_file = vm["read-device"].as<std::string>();
         ctx->uarch->init(ctx.get());
+        if (vm.count("write-device"))
+            ctx->writeDevice(vm["write-device"].as<std::string>());
+    } else if (vm.count("write-device")) {
+        log_error("--write-device requires --uarch; Python scripts can call ctx.writeDevice instead.\n");
+    } else if (vm.count("read-device")) {
+        ctx->readDevice(vm["read-device"].as<std::string>());
     } else if (vm.count("vopt")) {
         log_error("Viaduct options passed in non-viaduct mode!\n");
     } else if (vm.count("gui")) {
@@ -38,6 +38,8 @@ struct ExampleImpl : ViaductAPI
         init_uarch_constids(ctx);
         ViaductAPI::init(ctx);
         h.init(ctx);
+        if (ctx->device_loaded)
+            return;
         if (with_gui)
             init_bel_decals();
         init_wires();
@@ -45,6 +47,9 @@ struct ExampleImpl : ViaductAPI
         init_pips();
     }
 
+    // All device state is in the generic bels, wires and pips
+    bool saveDeviceState(std::vector<int32_t> &data) const override { return true; }
+
     void pack() override
     {
         // Trim nextpnr IOBs - assume IO buffer insertion has been done in synthesis
@@ -61,20 +61,23 @@ struct FabulousImpl : ViaductAPI
         init_uarch_constids(ctx);
         ViaductAPI::init(ctx);
         h.init(ctx);
-        fab_root = get_env_var("FAB_ROOT", ", set it to the fabulous build output or project path");
-        if (boost::filesystem::exists(fab_root + "/.FABulous"))
-            is_new_fab = true;
-        else
-            is_new_fab = false;
-        log_info("Detected FABulous %s format project.\n", is_new_fab ? "2.0" : "1.0");
         init_default_ctrlset_cfg();
-        // To consider: a faster serialised form of the device data (like bba that other arches use) so we don't have to
-        // go through the whole csv parsing malarkey each time
         blk_trk = std::make_unique<BlockTracker>(ctx, cfg);
-        is_new_fab ? init_bels_v2() : init_bels_v1();
-        init_pips();
-        init_pseudo_constant_wires();
-        setup_lut_permutation();
+        if (ctx->device_loaded) {
+            // Skip the csv parsing, as the device was loaded from a --write-device file
+            load_device_state();
+        } else {
+            fab_root = get_env_var("FAB_ROOT", ", set it to the fabulous build output or project path");
+            if (boost::filesystem::exists(fab_root + "/.FABulous"))
+                is_new_fab = true;
+            else
+                is_new_fab = false;
+            log_info("Detected FABulous %s format project.\n", is_new_fab ? "2.0" : "1.0");
+            is_new_fab ? init_bels_v2() : init_bels_v1();
+            init_pips();
+            init_pseudo_constant_wires();
+            setup_lut_permutation();
+        }
         ctx->setDelayScaling(3.0, 3.0);
         ctx->delay_epsilon = 0.25;
         ctx->ripup_penalty = 0.5;
@@ -133,6 +136,54 @@ struct FabulousImpl : ViaductAPI
 
     void pack() override { fabulous_pack(ctx, cfg); }
 
+    bool saveDeviceState(std::vector<int32_t> &data) const override
+    {
+        data.push_back(cfg.clb.lut_k);
+        data.push_back(global_clk_wire.index);
+        data.push_back(int32_t(pp_tags.size()));
+        for (const auto &tags : pp_tags) {
+            data.push_back(tags.type);
+            data.push_back(tags.bel.index);
+            data.push_back(tags.data);
+        }
+        data.push_back(int32_t(blk_trk->bel_data.size()));
+        for (const auto &flags : blk_trk->bel_data) {
+            data.push_back(flags.block);
+            data.push_back(flags.func);
+            data.push_back(flags.index);
+        }
+        return true;
+    }
+
+    void load_device_state()
+    {
+        const auto &data = ctx->uarch_device_state;
+        size_t pos = 0;
+        auto next = [&]() {
+            if (pos >= data.size())
+                log_error("FABulous state in device file is truncated\n");
+            return data.at(pos++);
+        };
+        int lut_k = next();
+        if (lut_k != int(cfg.clb.lut_k))
+            log_error("device file was built with lut_k=%d, but lut_k=%d is in use\n", lut_k, int(cfg.clb.lut_k));
+        global_clk_wire = WireId(next());
+        pp_tags.resize(next());
+        for (auto &tags : pp_tags) {
+            tags.type = PseudoPipTags::PPType(next());
+            tags.bel = BelId(next());
+            tags.data = uint16_t(next());
+        }
+        int num_bels = next();
+        for (int i = 0; i < num_bels; i++) {
+            auto block = BelFlags::BlockType(next());
+            auto func = BelFlags::FuncType(next());
+            uint8_t index = uint8_t(next());
+            if (block != BelFlags::BLOCK_OTHER)
+                blk_trk->set_bel_type(BelId(i), block, func, index);
+        }
+    }
+
     void postRoute() override
     {
         if (!fasm_file.empty())
@@ -539,8 +590,9 @@ struct FabulousImpl : ViaductAPI
         // this way we don't store a full string in memory of every concatenated wire name, reducing the memory
         // footprint and start time significantly beyond the ~1k LUT scale
         auto wire_name = IdStringList::concat(tile, wire);
-        auto found = ctx->wire_by_name.find(wire_name);
-        if (found != ctx->wire_by_name.end())
+        auto &wire_names = ctx->wire_name_map();
+        auto found = wire_names.find(wire_name);
+        if (found != wire_names.end())
             return found->second;
         // doesn't exist
         Loc loc = tile_loc(tile);
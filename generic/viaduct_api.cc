@@ -24,7 +24,13 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
-void ViaductAPI::init(Context *ctx) { this->ctx = ctx; }
+void ViaductAPI::init(Context *ctx)
+{
+    this->ctx = ctx;
+    // Loaded here rather than up front, so that the uarch constids have already been added
+    if (!ctx->device_file.empty())
+        ctx->readDevice(ctx->device_file);
+}
 
 std::vector<IdString> ViaductAPI::getCellTypes() const
 {
@@ -93,6 +93,13 @@ struct ViaductAPI
     virtual void preRoute(){};
     virtual void postRoute(){};
 
+    // --- Bulk device loading ---
+    // Append any state built alongside the device in init() that can't be recovered from the bels, wires and pips, so
+    // the device can be saved with Arch::writeDevice; return false if unsupported. ViaductAPI::init loads the device
+    // if one was given; after that, if ctx->device_loaded is set, init() should restore this state from
+    // ctx->uarch_device_state instead of building the device.
+    virtual bool saveDeviceState(std::vector<int32_t> &data) const { return false; }
+
     virtual ~ViaductAPI(){};
 };
 
@@ -116,7 +116,7 @@ std::string format_port_bits(const PortGroup &port, int &dummy_idx)
 void write_module(std::ostream &f, Context *ctx)
 {
     auto val = ctx->attrs.find(ctx->id("module"));
-    int dummy_idx = int(ctx->idstring_idx_to_str->size()) + 1000;
+    int dummy_idx = ctx->idstring_db->size() + 1000;
     if (val != ctx->attrs.end())
         f << stringf("    %s: {\n", get_string(val->second.as_string()).c_str());
     else
@@ -20,10 +20,16 @@
 
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/range/adaptor/reversed.hpp>
+#include <boost/uuid/detail/sha1.hpp>
+#include <chrono>
 #include <cmath>
 #include <cstring>
+#include <iomanip>
+#include <limits>
 #include <queue>
+#include <sstream>
 #include "log.h"
 #include "nextpnr.h"
 #include "placer1.h"
@@ -64,6 +70,47 @@ void IdString::initialize_arch(const BaseCtx *ctx)
 
 static const ChipInfoPOD *get_chip_info(const RelPtr<ChipInfoPOD> *ptr) { return ptr->get(); }
 
+static std::string sha1_hash(const char *data, size_t size)
+{
+    boost::uuids::detail::sha1 hasher;
+    hasher.process_bytes(data, size);
+
+    // unsigned int[5]
+    boost::uuids::detail::sha1::digest_type digest;
+    hasher.get_digest(digest);
+
+    std::ostringstream buf;
+    for (int i = 0; i < 5; ++i)
+        buf << std::hex << std::setfill('0') << std::setw(8) << digest[i];
+
+    return buf.str();
+}
+
+// Fast 64-bit hash of a whole blob, in four independent lanes so it isn't bound by multiply latency. Used for the
+// lookahead cache key, as sha1_hash over a large chipdb takes longer than loading the lookahead.
+static uint64_t blob_hash(const char *data, size_t size)
+{
+    const uint64_t mul = 0x9e3779b97f4a7c15ULL;
+    uint64_t lanes[4] = {1, 2, 3, 4};
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int j = 0; j < 4; j++) {
+            uint64_t word;
+            std::memcpy(&word, data + i + 8 * j, sizeof(word));
+            lanes[j] = (lanes[j] ^ word) * mul;
+            lanes[j] ^= lanes[j] >> 29;
+        }
+    }
+    uint64_t hash = size;
+    for (; i < size; i++)
+        hash = (hash ^ uint8_t(data[i])) * mul;
+    for (int j = 0; j < 4; j++) {
+        hash = (hash ^ lanes[j]) * mul;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
 Arch::Arch(ArchArgs args) : args(args)
 {
     try {
@@ -77,7 +124,7 @@ Arch::Arch(ArchArgs args) : args(args)
     }
 
     for (int i = 0; i < chip_info->extra_constids->bba_id_count; i++) {
-        // log_info("%s %d\n", chip_info->extra_constids->bba_ids[i].get(), int(idstring_idx_to_str->size()));
+        // log_info("%s %d\n", chip_info->extra_constids->bba_ids[i].get(), idstring_db->size());
         IdString::initialize_add(this, chip_info->extra_constids->bba_ids[i].get(),
                                  i + chip_info->extra_constids->known_id_count);
     }
@@ -93,8 +140,27 @@ Arch::Arch(ArchArgs args) : args(args)
         tileStatus[i].sitevariant.resize(chip_info->tile_insts[i].num_sites);
     }
 
+    setup_pip_avail();
     if (xc7)
         setup_pip_blacklist();
+
+    setup_flat_wires();
+
+    if (chip_info->version >= CHIPDB_VERSION_NODE_PIPS && !args.disable_node_pip_index) {
+        const NodePipIndexPOD *index = chip_info->node_pip_index.get();
+        if (index->num_nodes == chip_info->num_nodes)
+            node_pips = index;
+    }
+
+    if (chip_info->version >= CHIPDB_VERSION_INT_LOC_OVERRIDES) {
+        for (int i = 0; i < chip_info->num_int_loc_overrides; i++) {
+            auto &ovr = chip_info->int_loc_overrides[i];
+            WireId wire;
+            wire.tile = ovr.tile;
+            wire.index = ovr.index;
+            int_loc_overrides[wire] = Loc(ovr.int_x, ovr.int_y, 0);
+        }
+    }
 }
 
 // -----------------------------------------------------------------------
@@ -338,6 +404,115 @@ IdStringList Arch::getPipName(PipId pip) const
     }
 }
 
+void Arch::setup_flat_wires()
+{
+    int64_t total_tile_wires = 0;
+    for (int i = 0; i < chip_info->num_tiles; i++)
+        total_tile_wires += chip_info->tile_insts[i].num_tile_wires;
+    tile_flat_wire_base.resize(chip_info->num_tiles + 1);
+    tile_flat_rank_base.resize(chip_info->num_tiles);
+    tile_wire_flat_rank.resize(total_tile_wires);
+
+    int64_t flat_idx = chip_info->num_nodes;
+    int32_t rank_base = 0;
+    for (int i = 0; i < chip_info->num_tiles; i++) {
+        auto &ti = chip_info->tile_insts[i];
+        tile_flat_wire_base[i] = int32_t(flat_idx);
+        tile_flat_rank_base[i] = rank_base;
+        int32_t rank = 0;
+        for (int j = 0; j < ti.num_tile_wires; j++)
+            tile_wire_flat_rank[rank_base + j] = (ti.tile_wire_to_node[j] == -1) ? rank++ : -1;
+        flat_idx += rank + (chip_info->tile_types[ti.type].num_wires - ti.num_tile_wires);
+        rank_base += ti.num_tile_wires;
+    }
+    tile_flat_wire_base[chip_info->num_tiles] = int32_t(flat_idx);
+    NPNR_ASSERT(flat_idx < std::numeric_limits<int32_t>::max());
+    num_flat_wires = int(flat_idx);
+    wire_bind.init(num_flat_wires);
+    reserved_wires.init(num_flat_wires);
+}
+
+void Arch::benchPipIterators()
+{
+    const NodePipIndexPOD *index = node_pips;
+    if (index == nullptr)
+        log_warning("chipdb has no node pip index (version %d), only timing the tile wire walk\n", chip_info->version);
+    const int reps = 3;
+    uint64_t checksum[2] = {0, 0};
+    for (int mode = 0; mode < 2; mode++) {
+        if (mode == 1 && index == nullptr)
+            break;
+        node_pips = (mode == 1) ? index : nullptr;
+        auto start = std::chrono::high_resolution_clock::now();
+        uint64_t count = 0, sum = 0;
+        for (int r = 0; r < reps; r++) {
+            for (int i = 0; i < chip_info->num_nodes; i++) {
+                WireId wire;
+                wire.index = i;
+                for (PipId pip : getPipsDownhill(wire)) {
+                    sum = sum * 31 + uint64_t(pip.tile) * 65537 + pip.index;
+                    ++count;
+                }
+                for (PipId pip : getPipsUphill(wire)) {
+                    sum = sum * 31 + uint64_t(pip.tile) * 65537 + pip.index;
+                    ++count;
+                }
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double secs = std::chrono::duration<double>(end - start).count();
+        checksum[mode] = sum;
+        log_info("%s: %d nodes, %.02fM pips in %.03fs (%.02f Mpips/s)\n",
+                 (mode == 1) ? "node pip index" : "tile wire walk", chip_info->num_nodes, count / 1e6, secs,
+                 (count / 1e6) / std::max(secs, 1e-9));
+    }
+    node_pips = index;
+    if (index != nullptr && checksum[0] != checksum[1])
+        log_error("node pip index does not match the tile wire walk\n");
+}
+
+void Arch::setup_pip_avail()
+{
+    pip_avail_class.resize(chip_info->num_tiletypes);
+    for (int i = 0; i < chip_info->num_tiletypes; i++) {
+        auto &td = chip_info->tile_types[i];
+        auto &cls = pip_avail_class[i];
+        cls.resize(td.num_pips, PIP_AVAIL_ALWAYS);
+        for (int j = 0; j < td.num_pips; j++) {
+            auto &pd = td.pip_data[j];
+            uint8_t eight = uint8_t((pd.extra_data >> 8) & 0xF);
+            switch (pd.flags) {
+            case PIP_SITE_ENTRY:
+                if (td.wire_data[pd.dst_index].intent == ID_INTENT_SITE_GND)
+                    cls[j] = PIP_AVAIL_GND_ENTRY;
+                break;
+            case PIP_CONST_DRIVER:
+                cls[j] = PIP_AVAIL_CONST_DRIVER;
+                break;
+            case PIP_SITE_INTERNAL:
+                if (pd.bel == ID_TRIBUF)
+                    cls[j] = PIP_AVAIL_NEVER;
+                else if (pd.site >= 0 && pd.site_variant > 0)
+                    cls[j] = PIP_AVAIL_SITE_VARIANT;
+                break;
+            case PIP_LUT_PERMUTATION:
+                // from==to is always valid
+                if (((pd.extra_data >> 4) & 0xF) != (pd.extra_data & 0xF))
+                    cls[j] = PIP_AVAIL_LUT_PERM | (eight << 4);
+                break;
+            case PIP_LUT_ROUTETHRU:
+                if (eight == 0)
+                    cls[j] = PIP_AVAIL_NEVER; // FIXME: conflict with ground
+                else if (pd.extra_data & 0x1)
+                    cls[j] = PIP_AVAIL_NEVER; // FIXME: routethru to MUX
+                else
+                    cls[j] = PIP_AVAIL_LUT_THRU | (eight << 4);
+                break;
+            }
+        }
+    }
+}
+
 void Arch::setup_pip_blacklist()
 {
     for (int i = 0; i < chip_info->num_tiletypes; i++) {
@@ -348,11 +523,11 @@ void Arch::setup_pip_blacklist()
                 auto &pd = td.pip_data[j];
                 std::string dest_name = IdString(td.wire_data[pd.dst_index].name).str(this);
                 if (dest_name.find("FREQ_REF") != std::string::npos)
-                    blacklist_pips[td.type].insert(j);
+                    pip_avail_class[i][j] = PIP_AVAIL_NEVER;
             }
         } else if (boost::starts_with(type, "CMT_TOP_L_LOWER")) {
             for (int j = 0; j < td.num_pips; j++) {
-                blacklist_pips[td.type].insert(j);
+                pip_avail_class[i][j] = PIP_AVAIL_NEVER;
             }
         } else if (boost::starts_with(type, "CLK_HROW_TOP")) {
             for (int j = 0; j < td.num_pips; j++) {
@@ -362,7 +537,7 @@ void Arch::setup_pip_blacklist()
 
                 if (dest_name.find("CK_BUFG_CASCO") != std::string::npos &&
                     src_name.find("CK_BUFG_CASCIN") != std::string::npos)
-                    blacklist_pips[td.type].insert(j);
+                    pip_avail_class[i][j] = PIP_AVAIL_NEVER;
             }
         } else if (boost::starts_with(type, "HCLK_IOI")) {
             for (int j = 0; j < td.num_pips; j++) {
@@ -372,7 +547,7 @@ void Arch::setup_pip_blacklist()
 
                 if (dest_name.find("RCLK_BEFORE_DIV") != std::string::npos &&
                     src_name.find("IMUX") != std::string::npos)
-                    blacklist_pips[td.type].insert(j);
+                    pip_avail_class[i][j] = PIP_AVAIL_NEVER;
             }
         } else if (type.find("IOI") != std::string::npos) {
             for (int j = 0; j < td.num_pips; j++) {
@@ -381,11 +556,11 @@ void Arch::setup_pip_blacklist()
                 std::string src_name = IdString(td.wire_data[pd.src_index].name).str(this);
 
                 if (dest_name.find("CLKB") != std::string::npos && src_name.find("IMUX22") != std::string::npos)
-                    blacklist_pips[td.type].insert(j);
+                    pip_avail_class[i][j] = PIP_AVAIL_NEVER;
                 if (dest_name.find("OCLKB") != std::string::npos && src_name.find("IOI_OCLK_") != std::string::npos)
-                    blacklist_pips[td.type].insert(j);
+                    pip_avail_class[i][j] = PIP_AVAIL_NEVER;
                 if (dest_name.find("OCLKM") != std::string::npos && src_name.find("IMUX31") != std::string::npos)
-                    blacklist_pips[td.type].insert(j);
+                    pip_avail_class[i][j] = PIP_AVAIL_NEVER;
             }
         } else if (boost::starts_with(type, "CMT_TOP_R")) {
             for (int j = 0; j < td.num_pips; j++) {
@@ -394,9 +569,9 @@ void Arch::setup_pip_blacklist()
                 std::string src_name = IdString(td.wire_data[pd.src_index].name).str(this);
 
                 if (dest_name.find("PLLOUT_CLK_FREQ_BB_REBUFOUT") != std::string::npos)
-                    blacklist_pips[td.type].insert(j);
+                    pip_avail_class[i][j] = PIP_AVAIL_NEVER;
                 if (dest_name.find("MMCM_CLK_FREQ_BB") != std::string::npos)
-                    blacklist_pips[td.type].insert(j);
+                    pip_avail_class[i][j] = PIP_AVAIL_NEVER;
             }
         }
     }
@@ -453,13 +628,15 @@ delay_t Arch::estimateDelay(WireId src, WireId dst) const
     int src_intent = wireIntent(src); //, dst_intent = wireIntent(dst);
     // if (src_intent == ID_PSEUDO_GND || dst_intent == ID_PSEUDO_VCC)
     //    return 500;
-    int dst_tile = dst.tile == -1 ? chip_info->nodes[dst.index].tile_wires[0].tile : dst.tile;
-    int src_tile = src.tile == -1 ? chip_info->nodes[src.index].tile_wires[0].tile : src.tile;
-
-    if (sink_locs.count(dst)) {
-        dst_x = sink_locs.at(dst).x;
-        dst_y = sink_locs.at(dst).y;
-        if (src_tile == dst_tile || (sink_locs.count(src) && (sink_locs.at(dst) == sink_locs.at(src)))) {
+    int dst_tile = wireAnchorTile(dst);
+    int src_tile = wireAnchorTile(src);
+
+    Loc dst_int, src_int;
+    bool dst_is_pin = getWireIntLoc(dst, false, dst_int);
+    if (dst_is_pin) {
+        dst_x = dst_int.x;
+        dst_y = dst_int.y;
+        if (src_tile == dst_tile || (getWireIntLoc(src, false, src_int) && dst_int == src_int)) {
             return 1000;
         }
     } else if (dst.tile != -1 && chip_info->tile_insts[dst.tile].num_sites > 0) {
@@ -476,6 +653,18 @@ delay_t Arch::estimateDelay(WireId src, WireId dst) const
         dst_y = dst_tile / chip_info->width;
     }
 
+    if (lookahead.is_ready() && src_intent != ID_PSEUDO_GND && src_intent != ID_PSEUDO_VCC &&
+        (src.tile == -1 || wireInfo(src).site == -1)) {
+        // General routing source; use the precomputed lookahead tables, which are relative to the anchor tile
+        delay_t delay;
+        if (lookahead.lookup(src_intent, dst_x - (src_tile % chip_info->width), dst_y - (src_tile / chip_info->width),
+                             delay)) {
+            if (dst_is_pin)
+                delay += 1000;
+            return delay;
+        }
+    }
+
     if (src.tile == -1) {
         if (src_intent == ID_PSEUDO_GND || src_intent == ID_PSEUDO_VCC) {
             if (gnd_glbl == IdString()) {
@@ -547,7 +736,7 @@ delay_t Arch::estimateDelay(WireId src, WireId dst) const
     if (xc7)
         base = (base * 3) / 2;
 
-    if (sink_locs.count(dst))
+    if (dst_is_pin)
         base += 1000;
     if (src_intent == ID_NODE_PINFEED && dst_x == src_x && dst_y == src_y)
         base -= 200;
@@ -578,11 +767,12 @@ BoundingBox Arch::getRouteBoundingBox(WireId src, WireId dst) const
 
     expand(dst_tile % chip_info->width, dst_tile / chip_info->width);
 
-    if (source_locs.count(src))
-        expand(source_locs.at(src).x, source_locs.at(src).y);
+    Loc int_loc;
+    if (getWireIntLoc(src, true, int_loc))
+        expand(int_loc.x, int_loc.y);
 
-    if (sink_locs.count(dst)) {
-        expand(sink_locs.at(dst).x, sink_locs.at(dst).y);
+    if (getWireIntLoc(dst, false, int_loc)) {
+        expand(int_loc.x, int_loc.y);
     } else if (dst.tile != -1 && chip_info->tile_insts[dst.tile].num_sites > 0) {
         auto &site = chip_info->tile_insts[dst.tile].site_insts[wireInfo(dst).site != -1 ? wireInfo(dst).site : 0];
         if (site.inter_x != -1) {
@@ -652,6 +842,13 @@ bool Arch::place()
     std::string placer = str_or_default(settings, id_placer, defaultPlacer);
 
     if (placer == "heap") {
+#ifndef NPNR_DISABLE_THREADS
+        // Tile status updates happen under the detail placer's exclusive arch lock and validity caches are
+        // locked per tile, so the parallel refinement engine is safe to use by default
+        IdString refine_setting = id("placerHeap/parallelRefine");
+        if (!getCtx()->settings.count(refine_setting))
+            getCtx()->settings[refine_setting] = true;
+#endif
         PlacerHeapCfg cfg(getCtx());
         cfg.criticalityExponent = 7;
         cfg.ioBufTypes.insert(id_IOB_IBUFCTRL);
@@ -685,12 +882,119 @@ bool Arch::place()
     return true;
 }
 
+void Arch::postLoadPlacement()
+{
+    fixupPlacement();
+    getCtx()->attrs[id_step] = std::string("place");
+    archInfoToAttributes();
+}
+
+namespace {
+// Router for the Vcc pseudo-net and global clocks, which can have tens of thousands of sinks. All sinks of a net
+// grow a single routing tree with one multi-source breadth-first search: the wavefront is seeded with every wire
+// already in the tree and expands downhill, and each sink is claimed, binding the path back to the tree, as soon as
+// the front reaches it. Visit state is stamped per search in a paged flat-wire array shared by all nets, so the
+// searches themselves allocate nothing.
+struct GlobalNetRouter
+{
+    explicit GlobalNetRouter(Arch *arch) : arch(arch) { visit.init(arch->num_flat_wires); }
+
+    Arch *arch;
+    struct VisitState
+    {
+        uint32_t stamp = 0, sink_stamp = 0;
+        PipId uphill;
+    };
+    PagedWireArray<VisitState> visit;
+    std::vector<WireId> queue;
+    uint32_t stamp = 0;
+    int64_t wires_visited = 0;
+
+    VisitState &state(WireId wire) { return visit.at(arch->getFlatWireIndex(wire)); }
+
+    // Bind the path found to a sink, back to the first wire that is already part of the tree
+    void bind_path(NetInfo *net, WireId wire, PlaceStrength strength)
+    {
+        while (arch->getBoundWireNet(wire) != net) {
+            PipId uh = state(wire).uphill;
+            NPNR_ASSERT(uh != PipId());
+            if (arch->getCtx()->debug)
+                log_info("            bind pip %s --> %s\n", arch->nameOfPip(uh), arch->nameOfWire(wire));
+            arch->bindWire(wire, net, strength);
+            arch->bindPip(uh, net, strength);
+            wire = arch->getPipSrcWire(uh);
+        }
+    }
+
+    // Join sinks to the existing routing tree of net, only searching through wires accepted by allow. Returns the
+    // sinks that can't be reached.
+    template <typename TAllow>
+    std::vector<WireId> route_sinks(NetInfo *net, const std::vector<WireId> &sinks, PlaceStrength strength,
+                                    TAllow allow)
+    {
+        if (++stamp == 0) {
+            visit.clear();
+            stamp = 1;
+        }
+        int pending = 0;
+        for (WireId sink : sinks) {
+            auto &sink_state = state(sink);
+            if (sink_state.sink_stamp != stamp && arch->getBoundWireNet(sink) != net) {
+                sink_state.sink_stamp = stamp;
+                ++pending;
+            }
+        }
+        queue.clear();
+        for (auto &wire : net->wires) {
+            auto &seed_state = state(wire.first);
+            seed_state.stamp = stamp;
+            seed_state.uphill = PipId();
+            queue.push_back(wire.first);
+        }
+        for (size_t head = 0; head < queue.size() && pending > 0; head++) {
+            WireId curr = queue.at(head);
+            for (auto dh : arch->getPipsDownhill(curr)) {
+                if (!arch->checkPipAvail(dh))
+                    continue;
+                WireId dst = arch->getPipDstWire(dh);
+                auto &dst_state = state(dst);
+                if (dst_state.stamp == stamp)
+                    continue;
+                bool is_sink = (dst_state.sink_stamp == stamp);
+                if (!is_sink && !allow(dst))
+                    continue;
+                if (!arch->checkWireAvail(dst) && arch->getBoundWireNet(dst) != net)
+                    continue;
+                dst_state.stamp = stamp;
+                dst_state.uphill = dh;
+                if (is_sink) {
+                    // Sinks are leaves, so the front doesn't continue through them
+                    bind_path(net, dst, strength);
+                    --pending;
+                } else {
+                    queue.push_back(dst);
+                }
+            }
+        }
+        wires_visited += queue.size();
+        std::vector<WireId> unrouted;
+        for (WireId sink : sinks)
+            if (arch->getBoundWireNet(sink) != net)
+                unrouted.push_back(sink);
+        return unrouted;
+    }
+};
+} // namespace
+
 void Arch::routeVcc()
 {
     log_info("Routing Vcc connections...\n");
     // Special pass for faster routing of Vcc psuedo-net
     NetInfo *vcc = nets[id("$PACKER_VCC_NET")].get();
-    bindWire(getCtx()->getNetinfoSourceWire(vcc), vcc, STRENGTH_STRONG);
+    // The source may already be bound, with routing restored from a checkpoint
+    WireId vcc_src = getCtx()->getNetinfoSourceWire(vcc);
+    if (getBoundWireNet(vcc_src) != vcc)
+        bindWire(vcc_src, vcc, STRENGTH_STRONG);
 #if 0
     WireId wire0 = getCtx()->getNetinfoSourceWire(vcc);
     Loc drvloc = getBelLocation(vcc->driver.cell->bel);
@@ -705,47 +1009,31 @@ void Arch::routeVcc()
 
     }
 #endif
+    auto rstart = std::chrono::high_resolution_clock::now();
+    GlobalNetRouter router(this);
+    std::vector<WireId> sinks;
     for (auto &usr : vcc->users) {
-        std::queue<WireId> visit;
-        dict<WireId, PipId> backtrace;
-        WireId dest = WireId();
         WireId sink = getCtx()->getNetinfoSinkWire(vcc, usr, 0);
         if (sink == WireId())
             log_error("Pin '%s' of bel '%s' has no associated wire\n", usr.port.c_str(this), nameOfBel(usr.cell->bel));
-        visit.push(sink);
-        while (!visit.empty()) {
-            WireId curr = visit.front();
-            visit.pop();
-            if (getBoundWireNet(curr) == vcc) {
-                dest = curr;
-                break;
-            }
-            for (auto uh : getPipsUphill(curr)) {
-                if (!checkPipAvail(uh))
-                    continue;
-                WireId src = getPipSrcWire(uh);
-                if (backtrace.count(src))
-                    continue;
-                if (!checkWireAvail(src) && getBoundWireNet(src) != vcc)
-                    continue;
-                backtrace[src] = uh;
-                visit.push(src);
-            }
-        }
-        NPNR_ASSERT(dest != WireId());
-        while (backtrace.count(dest)) {
-            auto uh = backtrace[dest];
-            dest = getPipDstWire(uh);
-            bindWire(dest, vcc, STRENGTH_STRONG);
-            bindPip(uh, vcc, STRENGTH_STRONG);
-        }
+        sinks.push_back(sink);
+    }
+    if (std::all_of(sinks.begin(), sinks.end(), [&](WireId sink) { return getBoundWireNet(sink) == vcc; })) {
+        log_info("    all %d Vcc sinks already routed\n", int(sinks.size()));
+        return;
     }
+    auto unrouted = router.route_sinks(vcc, sinks, STRENGTH_STRONG, [](WireId) { return true; });
+    NPNR_ASSERT(unrouted.empty());
+    auto rend = std::chrono::high_resolution_clock::now();
+    log_info("    routed %d Vcc sinks in %.02fs (%lld wires visited)\n", int(vcc->users.entries()),
+             std::chrono::duration<float>(rend - rstart).count(), (long long)router.wires_visited);
 }
 
 void Arch::routeClock()
 {
     log_info("Routing global clocks...\n");
     // Special pass for faster routing of global clock psuedo-net
+    GlobalNetRouter router(this);
     for (auto &net : nets) {
         NetInfo *clk_net = net.second.get();
         if (clk_net->driver.cell == nullptr)
@@ -767,14 +1055,44 @@ void Arch::routeClock()
         if (!is_global)
             continue;
 
-        log_info("    routing clock '%s'\n", clk_net->name.c_str(this));
-        bindWire(getCtx()->getNetinfoSourceWire(clk_net), clk_net, STRENGTH_LOCKED);
-
+        WireId clk_src = getCtx()->getNetinfoSourceWire(clk_net);
+        bool all_routed = getBoundWireNet(clk_src) == clk_net;
         for (auto &usr : clk_net->users) {
-            std::queue<WireId> visit;
-            dict<WireId, PipId> backtrace;
-            WireId dest = WireId();
+            if (!all_routed)
+                break;
+            WireId sink_wire = getCtx()->getNetinfoSinkWire(clk_net, usr, 0);
+            all_routed = sink_wire != WireId() && getBoundWireNet(sink_wire) == clk_net;
+        }
+        if (all_routed) {
+            // e.g. restored from a checkpoint
+            log_info("    clock '%s' is already routed\n", clk_net->name.c_str(this));
+            continue;
+        }
 
+        log_info("    routing clock '%s'\n", clk_net->name.c_str(this));
+        if (getBoundWireNet(clk_src) != clk_net)
+            bindWire(clk_src, clk_net, STRENGTH_LOCKED);
+
+        // Clocks may only use the dedicated global network
+        auto dedicated_only = [&](WireId src) {
+            int intent = wireIntent(src);
+            return !(intent == ID_NODE_DOUBLE || intent == ID_NODE_HLONG || intent == ID_NODE_HQUAD ||
+                     intent == ID_NODE_VLONG || intent == ID_NODE_VQUAD || intent == ID_NODE_SINGLE ||
+                     intent == ID_NODE_CLE_OUTPUT || intent == ID_NODE_OPTDELAY || intent == ID_BENTQUAD ||
+                     intent == ID_DOUBLE || intent == ID_HLONG || intent == ID_HQUAD || intent == ID_OPTDELAY ||
+                     intent == ID_SINGLE || intent == ID_VLONG || intent == ID_VLONG12 || intent == ID_VQUAD ||
+                     intent == ID_PINBOUNCE);
+        };
+        // Due to some missing pips, currently special case more lenient solution for PLL inputs
+        bool pll_input = clk_net->users.entries() == 1 &&
+                         (*clk_net->users.begin()).cell->type == id_PLLE2_ADV_PLLE2_ADV &&
+                         (*clk_net->users.begin()).port == id_CLKIN1;
+
+        auto rstart = std::chrono::high_resolution_clock::now();
+        int64_t visited_before = router.wires_visited;
+        int failed = 0;
+        std::vector<WireId> sinks;
+        for (auto &usr : clk_net->users) {
             auto sink_wire = getCtx()->getNetinfoSinkWire(clk_net, usr, 0);
             if (getCtx()->debug) {
                 auto sink_wire_name = "(uninitialized)";
@@ -783,78 +1101,22 @@ void Arch::routeClock()
                 log_info("        routing arc to %s.%s (wire %s):\n", usr.cell->name.c_str(this), usr.port.c_str(this),
                          sink_wire_name);
             }
-
-            visit.push(sink_wire);
-            while (!visit.empty()) {
-                WireId curr = visit.front();
-                visit.pop();
-                if (getBoundWireNet(curr) == clk_net) {
-                    dest = curr;
-                    break;
-                }
-                for (auto uh : getPipsUphill(curr)) {
-                    if (!checkPipAvail(uh))
-                        continue;
-                    WireId src = getPipSrcWire(uh);
-                    if (backtrace.count(src))
-                        continue;
-                    int intent = wireIntent(src);
-                    if (intent == ID_NODE_DOUBLE || intent == ID_NODE_HLONG || intent == ID_NODE_HQUAD ||
-                        intent == ID_NODE_VLONG || intent == ID_NODE_VQUAD || intent == ID_NODE_SINGLE ||
-                        intent == ID_NODE_CLE_OUTPUT || intent == ID_NODE_OPTDELAY || intent == ID_BENTQUAD ||
-                        intent == ID_DOUBLE || intent == ID_HLONG || intent == ID_HQUAD || intent == ID_OPTDELAY ||
-                        intent == ID_SINGLE || intent == ID_VLONG || intent == ID_VLONG12 || intent == ID_VQUAD ||
-                        intent == ID_PINBOUNCE)
-                        continue;
-                    if (!checkWireAvail(src) && getBoundWireNet(src) != clk_net)
-                        continue;
-                    backtrace[src] = uh;
-                    visit.push(src);
-                }
-            }
-            if (dest == WireId()) {
-                log_info("            failed to find a route using dedicated resources.\n");
-                if (clk_net->users.entries() == 1 && (*clk_net->users.begin()).cell->type == id_PLLE2_ADV_PLLE2_ADV &&
-                    (*clk_net->users.begin()).port == id_CLKIN1) {
-                    // Due to some missing pips, currently special case more lenient solution
-                    std::queue<WireId> empty;
-                    std::swap(visit, empty);
-                    backtrace.clear();
-                    visit.push(sink_wire);
-                    while (!visit.empty()) {
-                        WireId curr = visit.front();
-                        visit.pop();
-                        if (getBoundWireNet(curr) == clk_net) {
-                            dest = curr;
-                            break;
-                        }
-                        for (auto uh : getPipsUphill(curr)) {
-                            if (!checkPipAvail(uh))
-                                continue;
-                            WireId src = getPipSrcWire(uh);
-                            if (backtrace.count(src))
-                                continue;
-                            if (!checkWireAvail(src) && getBoundWireNet(src) != clk_net)
-                                continue;
-                            backtrace[src] = uh;
-                            visit.push(src);
-                        }
-                    }
-                    if (dest == WireId())
-                        continue;
-                } else {
-                    continue;
-                }
-            }
-            while (backtrace.count(dest)) {
-                auto uh = backtrace[dest];
-                dest = getPipDstWire(uh);
-                if (getCtx()->debug)
-                    log_info("            bind pip %s --> %s\n", nameOfPip(uh), nameOfWire(dest));
-                bindWire(dest, clk_net, STRENGTH_LOCKED);
-                bindPip(uh, clk_net, STRENGTH_LOCKED);
-            }
+            if (sink_wire == WireId())
+                ++failed;
+            else
+                sinks.push_back(sink_wire);
         }
+        auto unrouted = router.route_sinks(clk_net, sinks, STRENGTH_LOCKED, dedicated_only);
+        if (!unrouted.empty()) {
+            log_info("        %d sinks failed to find a route using dedicated resources.\n", int(unrouted.size()));
+            if (pll_input)
+                unrouted = router.route_sinks(clk_net, unrouted, STRENGTH_LOCKED, [](WireId) { return true; });
+            failed += int(unrouted.size());
+        }
+        auto rend = std::chrono::high_resolution_clock::now();
+        log_info("        %d sinks (%d unrouted) in %.02fs (%lld wires visited)\n", int(clk_net->users.entries()),
+                 failed, std::chrono::duration<float>(rend - rstart).count(),
+                 (long long)(router.wires_visited - visited_before));
     }
 #if 0
     for (auto& net : nets) {
@@ -894,6 +1156,9 @@ void Arch::routeClock()
 
 void Arch::findSourceSinkLocations()
 {
+    // Newer chipdbs carry the interconnect location of every bel pin wire
+    if (chip_info->version >= CHIPDB_VERSION_INT_LOCS)
+        return;
     // Use a backwards BFS to find the real location of sinks, on a best-effort basis
 #if 1
     for (auto &net : nets) {
@@ -1000,6 +1265,45 @@ void Arch::findSourceSinkLocations()
 #endif
 }
 
+void Arch::setupLookahead()
+{
+    if (args.disable_lookahead || lookahead.is_ready())
+        return;
+    // The key covers the whole chipdb, and the lookahead build parameters; the tables don't depend on anything else
+    const char *blob = reinterpret_cast<const char *>(blob_file.data());
+    size_t blob_size = blob_file.size();
+    std::ostringstream key;
+    key << chip_info->name.get() << ';' << chip_info->generator.get() << ';' << chip_info->version << ';'
+        << blob_size << ';' << std::hex << blob_hash(blob, blob_size) << std::dec << ';'
+        << Lookahead::build_params(getCtx());
+    std::string key_str = key.str();
+    std::string chipdb_key = sha1_hash(key_str.data(), key_str.size());
+
+    std::string cache_dir = args.lookahead_cache_dir;
+    if (cache_dir.empty()) {
+        const char *xdg_cache = getenv("XDG_CACHE_HOME");
+        const char *home = getenv("HOME");
+        if (xdg_cache != nullptr && xdg_cache[0] != '\0')
+            cache_dir = (boost::filesystem::path(xdg_cache) / "nextpnr-xilinx").string();
+        else if (home != nullptr && home[0] != '\0')
+            cache_dir = (boost::filesystem::path(home) / ".cache" / "nextpnr-xilinx").string();
+    }
+    if (cache_dir.empty()) {
+        lookahead.init(getCtx(), chipdb_key, "", /*rebuild=*/true, /*write_file=*/false);
+        return;
+    }
+    std::string filename =
+            (boost::filesystem::path(cache_dir) /
+             (boost::filesystem::path(args.chipdb).stem().string() + "-" + chipdb_key.substr(0, 16) + ".lookahead"))
+                    .string();
+    bool write_file = !args.dont_write_lookahead;
+    if (write_file) {
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(cache_dir, ec);
+    }
+    lookahead.init(getCtx(), chipdb_key, filename, args.rebuild_lookahead, write_file);
+}
+
 bool Arch::route()
 {
     assign_budget(getCtx(), true);
@@ -1008,6 +1312,7 @@ bool Arch::route()
         routeVcc();
     routeClock();
     findSourceSinkLocations();
+    setupLookahead();
 
     bool result;
     if (router == "router1") {
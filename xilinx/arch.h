@@ -25,7 +25,10 @@
 #include <boost/iostreams/device/mapped_file.hpp>
 
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include "base_arch.h"
+#include "lookahead.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
@@ -183,11 +186,19 @@ NPNR_PACKED_STRUCT(struct TileWireInfoPOD {
     RelPtr<BelPortPOD> bel_pins;
 
     int16_t site; // Site index in tile
-    int16_t padding;
+    // Offset from this tile to the interconnect tile serving this bel pin wire, INT_LOC_NONE, or INT_LOC_PER_INST if
+    // it differs between tile instances. Only present from chipdb version 2 on; padding before that.
+    int8_t int_dx, int_dy;
 
     int32_t intent; // xilinx intent constid
 });
 
+static constexpr int8_t INT_LOC_NONE = -128;
+// Look up ChipInfoPOD::int_loc_overrides instead; only used from chipdb version 4 on
+static constexpr int8_t INT_LOC_PER_INST = -127;
+// First chipdb version with TileWireInfoPOD::int_dx/int_dy
+static constexpr int32_t CHIPDB_VERSION_INT_LOCS = 2;
+
 NPNR_PACKED_STRUCT(struct TileWireRefPOD {
     int32_t tile;
     int32_t index;
@@ -199,6 +210,30 @@ NPNR_PACKED_STRUCT(struct NodeInfoPOD {
     RelPtr<TileWireRefPOD> tile_wires;
 });
 
+// A pip given as (tile, pip index in tile); the same layout as PipId.
+NPNR_PACKED_STRUCT(struct TilePipRefPOD {
+    int32_t tile;
+    int32_t index;
+});
+
+// Flattened lists of the uphill and downhill pips of every node, in compressed sparse row form, so iterating the pips
+// of a node is a linear walk instead of a walk over each of its tile wires. The pips of node i are at
+// [offset[i], offset[i + 1]) and are in the same order as the tile wire walk. num_nodes is 0 when the chipdb was
+// exported without the index.
+NPNR_PACKED_STRUCT(struct NodePipIndexPOD {
+    int32_t num_nodes;
+    RelPtr<uint32_t> downhill_offset, uphill_offset; // num_nodes + 1 entries
+    RelPtr<TilePipRefPOD> downhill, uphill;
+});
+
+// Interconnect location of a node, or of a tile wire whose offset differs between instances of its tile type.
+// tile is -1 for a node, and index is then the node index.
+NPNR_PACKED_STRUCT(struct IntLocOverridePOD {
+    int32_t tile;
+    int32_t index;
+    int16_t int_x, int_y;
+});
+
 NPNR_PACKED_STRUCT(struct TileTypeInfoPOD {
     int32_t type;
 
@@ -325,8 +360,20 @@ NPNR_PACKED_STRUCT(struct ChipInfoPOD {
 
     int32_t num_speed_grades;
     RelPtr<TimingDataPOD> timing_data;
+
+    // Only present from chipdb version 3 on
+    RelPtr<NodePipIndexPOD> node_pip_index;
+
+    // Only present from chipdb version 4 on
+    int32_t num_int_loc_overrides;
+    RelPtr<IntLocOverridePOD> int_loc_overrides;
 });
 
+// First chipdb version with ChipInfoPOD::node_pip_index
+static constexpr int32_t CHIPDB_VERSION_NODE_PIPS = 3;
+// First chipdb version with ChipInfoPOD::int_loc_overrides and INT_LOC_PER_INST
+static constexpr int32_t CHIPDB_VERSION_INT_LOC_OVERRIDES = 4;
+
 /************************ End of chipdb section. ************************/
 
 struct BelIterator
@@ -555,9 +602,15 @@ struct UphillPipIterator
     const ChipInfoPOD *chip;
     TileWireIterator twi, twi_end;
     int cursor = -1;
+    // Set when walking a node using the chipdb node pip index; the tile wire fields are then unused
+    const TilePipRefPOD *csr = nullptr;
 
     void operator++()
     {
+        if (csr) {
+            ++csr;
+            return;
+        }
         cursor++;
         while (true) {
             if (!(twi != twi_end))
@@ -570,11 +623,21 @@ struct UphillPipIterator
             cursor = 0;
         }
     }
-    bool operator!=(const UphillPipIterator &other) const { return twi != other.twi || cursor != other.cursor; }
+    bool operator!=(const UphillPipIterator &other) const
+    {
+        if (csr)
+            return csr != other.csr;
+        return twi != other.twi || cursor != other.cursor;
+    }
 
     PipId operator*() const
     {
         PipId ret;
+        if (csr) {
+            ret.tile = csr->tile;
+            ret.index = csr->index;
+            return ret;
+        }
         WireId w = *twi;
         ret.tile = w.tile;
         ret.index = chip->tile_types[chip->tile_insts[w.tile].type].wire_data[w.index].pips_uphill[cursor];
@@ -594,9 +657,15 @@ struct DownhillPipIterator
     const ChipInfoPOD *chip;
     TileWireIterator twi, twi_end;
     int cursor = -1;
+    // Set when walking a node using the chipdb node pip index; the tile wire fields are then unused
+    const TilePipRefPOD *csr = nullptr;
 
     void operator++()
     {
+        if (csr) {
+            ++csr;
+            return;
+        }
         cursor++;
         while (true) {
             if (!(twi != twi_end))
@@ -609,11 +678,21 @@ struct DownhillPipIterator
             cursor = 0;
         }
     }
-    bool operator!=(const DownhillPipIterator &other) const { return twi != other.twi || cursor != other.cursor; }
+    bool operator!=(const DownhillPipIterator &other) const
+    {
+        if (csr)
+            return csr != other.csr;
+        return twi != other.twi || cursor != other.cursor;
+    }
 
     PipId operator*() const
     {
         PipId ret;
+        if (csr) {
+            ret.tile = csr->tile;
+            ret.index = csr->index;
+            return ret;
+        }
         WireId w = *twi;
         ret.tile = w.tile;
         ret.index = chip->tile_types[chip->tile_insts[w.tile].type].wire_data[w.index].pips_downhill[cursor];
@@ -671,6 +750,14 @@ struct BelPinRange
 struct ArchArgs
 {
     std::string chipdb;
+    // Router lookahead options
+    bool disable_lookahead = false;
+    bool rebuild_lookahead = false;
+    bool dont_write_lookahead = false;
+    // Where cached lookaheads are kept; a per-user cache directory if empty
+    std::string lookahead_cache_dir;
+    // Ignore the chipdb node pip index and walk node tile wires instead
+    bool disable_node_pip_index = false;
 };
 
 struct ArchRanges : BaseArchRanges
@@ -689,18 +776,65 @@ struct ArchRanges : BaseArchRanges
     using AllPipsRangeT = AllPipRange;
 };
 
+// Array indexed by flat wire index, with storage allocated a page at a time on first write. Memory use follows the
+// parts of the device actually used rather than its full size, while lookups stay a couple of array accesses.
+template <typename T> struct PagedWireArray
+{
+    static constexpr int page_bits = 10;
+    static constexpr int page_mask = (1 << page_bits) - 1;
+    std::vector<std::unique_ptr<T[]>> pages;
+
+    void init(int size)
+    {
+        pages.clear();
+        pages.resize((size + page_mask) >> page_bits);
+    }
+    void clear()
+    {
+        for (auto &page : pages)
+            page.reset();
+    }
+    // nullptr if nothing was ever written to the page containing idx
+    const T *find(int idx) const
+    {
+        auto &page = pages[idx >> page_bits];
+        return page ? &page[idx & page_mask] : nullptr;
+    }
+    T *find(int idx)
+    {
+        auto &page = pages[idx >> page_bits];
+        return page ? &page[idx & page_mask] : nullptr;
+    }
+    T &at(int idx)
+    {
+        auto &page = pages[idx >> page_bits];
+        if (!page)
+            page.reset(new T[1 << page_bits]());
+        return page[idx & page_mask];
+    }
+};
+
 struct Arch : BaseArch<ArchRanges>
 {
     boost::iostreams::mapped_file_source blob_file;
     const ChipInfoPOD *chip_info;
+    // Per-node pip lists used by getPipsDownhill/getPipsUphill, or nullptr if unavailable or disabled
+    const NodePipIndexPOD *node_pips = nullptr;
 
     mutable dict<std::string, int> tile_by_name;
     mutable dict<std::string, std::pair<int, int>> site_by_name;
 
-    dict<WireId, NetInfo *> wire_to_net;
-    dict<PipId, NetInfo *> pip_to_net;
-    dict<WireId, std::pair<int, int>> driving_pip_loc;
-    dict<WireId, NetInfo *> reserved_wires;
+    // Bind state, by flat wire index. A pip is bound exactly when it is the driving pip of its bound destination
+    // wire, so pips need no storage of their own.
+    struct WireBinding
+    {
+        NetInfo *net = nullptr;
+        PipId pip;
+        // Tile of the pip that last drove this wire; kept after unbinding, as a hint for delay estimates
+        int32_t driving_pip_tile = -1;
+    };
+    PagedWireArray<WireBinding> wire_bind;
+    PagedWireArray<NetInfo *> reserved_wires;
 
     struct LogicTileStatus
     {
@@ -716,6 +850,11 @@ struct Arch : BaseArch<ArchRanges>
         {
             bool valid = true, dirty = true;
         } halfs[8];
+#ifndef NPNR_DISABLE_THREADS
+        // The valid/dirty cache above is written by isBelLocationValid, which parallel refinement calls with
+        // only a shared lock on the arch held
+        std::mutex cache_mutex;
+#endif
     };
 
     struct BRAMTileStatus
@@ -729,6 +868,8 @@ struct Arch : BaseArch<ArchRanges>
         BRAMTileStatus *bts = nullptr;
         std::vector<CellInfo *> boundcells;
         std::vector<int> sitevariant;
+        // Per LUT eighth: bit set if its 5LUT or 6LUT is bound (lut_used) or is a memory/SRL (lut_mem)
+        uint8_t lut_used = 0, lut_mem = 0;
 
         ~TileStatus()
         {
@@ -805,6 +946,17 @@ struct Arch : BaseArch<ArchRanges>
                 ts.halfs[0].dirty = true; // WCLK and CLK0 shared
         }
         ts.cells[z] = cell;
+        if (((z & 0xF) == BEL_6LUT) || ((z & 0xF) == BEL_5LUT)) {
+            // Keep the pip availability masks in sync
+            int eight = z >> 4;
+            const CellInfo *lut6 = ts.cells[(eight << 4) | BEL_6LUT], *lut5 = ts.cells[(eight << 4) | BEL_5LUT];
+            auto is_mem = [](const CellInfo *c) {
+                return c != nullptr && (c->lutInfo.is_memory || c->lutInfo.is_srl);
+            };
+            uint8_t bit = uint8_t(1 << eight);
+            tts.lut_used = (lut6 != nullptr || lut5 != nullptr) ? (tts.lut_used | bit) : (tts.lut_used & ~bit);
+            tts.lut_mem = (is_mem(lut6) || is_mem(lut5)) ? (tts.lut_mem | bit) : (tts.lut_mem & ~bit);
+        }
         // determine which sections to mark as dirty
         switch (z & 0xF) {
         case BEL_FF:
@@ -1011,8 +1163,10 @@ struct Arch : BaseArch<ArchRanges>
     void bindWire(WireId wire, NetInfo *net, PlaceStrength strength)
     {
         NPNR_ASSERT(wire != WireId());
-        NPNR_ASSERT(wire_to_net[wire] == nullptr);
-        wire_to_net[wire] = net;
+        auto &wb = wire_bind.at(getFlatWireIndex(wire));
+        NPNR_ASSERT(wb.net == nullptr);
+        wb.net = net;
+        wb.pip = PipId();
         net->wires[wire].pip = PipId();
         net->wires[wire].strength = strength;
         refreshUiWire(wire);
@@ -1021,54 +1175,65 @@ struct Arch : BaseArch<ArchRanges>
     void unbindWire(WireId wire)
     {
         NPNR_ASSERT(wire != WireId());
-        NPNR_ASSERT(wire_to_net[wire] != nullptr);
+        auto wb = wire_bind.find(getFlatWireIndex(wire));
+        NPNR_ASSERT(wb != nullptr && wb->net != nullptr);
 
-        auto &net_wires = wire_to_net[wire]->wires;
+        auto &net_wires = wb->net->wires;
         auto it = net_wires.find(wire);
         NPNR_ASSERT(it != net_wires.end());
 
-        auto pip = it->second.pip;
-        if (pip != PipId()) {
-            pip_to_net[pip] = nullptr;
-        }
-
         net_wires.erase(it);
-        wire_to_net[wire] = nullptr;
+        wb->net = nullptr;
+        wb->pip = PipId();
         refreshUiWire(wire);
     }
 
     bool checkWireAvail(WireId wire) const
     {
         NPNR_ASSERT(wire != WireId());
-        auto w2n = wire_to_net.find(wire);
-        return w2n == wire_to_net.end() || w2n->second == nullptr;
+        auto wb = wire_bind.find(getFlatWireIndex(wire));
+        return wb == nullptr || wb->net == nullptr;
     }
 
     NetInfo *getReservedWireNet(WireId wire) const
     {
         NPNR_ASSERT(wire != WireId());
-        auto w2n = reserved_wires.find(wire);
-        return w2n == reserved_wires.end() ? nullptr : w2n->second;
+        auto rw = reserved_wires.find(getFlatWireIndex(wire));
+        return rw == nullptr ? nullptr : *rw;
     }
 
     NetInfo *getBoundWireNet(WireId wire) const
     {
         NPNR_ASSERT(wire != WireId());
-        auto w2n = wire_to_net.find(wire);
-        return w2n == wire_to_net.end() ? nullptr : w2n->second;
+        auto wb = wire_bind.find(getFlatWireIndex(wire));
+        return wb == nullptr ? nullptr : wb->net;
     }
 
     WireId getConflictingWireWire(WireId wire) const { return wire; }
 
-    NetInfo *getConflictingWireNet(WireId wire) const
+    NetInfo *getConflictingWireNet(WireId wire) const { return getBoundWireNet(wire); }
+
+    DelayQuad getWireDelay(WireId wire) const override { return DelayQuad(0); }
+
+    int getFlatWireCount() const override { return num_flat_wires; }
+
+    int getFlatWireIndex(WireId wire) const override
     {
         NPNR_ASSERT(wire != WireId());
-        auto w2n = wire_to_net.find(wire);
-        return w2n == wire_to_net.end() ? nullptr : w2n->second;
+        if (wire.tile == -1)
+            return wire.index;
+        auto &ti = chip_info->tile_insts[wire.tile];
+        if (wire.index < ti.num_tile_wires) {
+            int32_t rank = tile_wire_flat_rank[tile_flat_rank_base[wire.tile] + wire.index];
+            // A non-canonical tile-local id of a nodal wire maps to its node, as canonicalWireId would
+            if (rank == -1)
+                return ti.tile_wire_to_node[wire.index];
+            return tile_flat_wire_base[wire.tile] + rank;
+        }
+        // Wires beyond the end of tile_wire_to_node can't be nodal, so are packed at the end of the tile's range
+        return tile_flat_wire_base[wire.tile + 1] - chip_info->tile_types[ti.type].num_wires + wire.index;
     }
 
-    DelayQuad getWireDelay(WireId wire) const override { return DelayQuad(0); }
-
     TileWireRange getTileWireRange(WireId wire) const
     {
         TileWireRange range;
@@ -1124,15 +1289,14 @@ struct Arch : BaseArch<ArchRanges>
     void bindPip(PipId pip, NetInfo *net, PlaceStrength strength)
     {
         NPNR_ASSERT(pip != PipId());
-        NPNR_ASSERT(pip_to_net[pip] == nullptr);
 
         WireId dst = canonicalWireId(chip_info, pip.tile, locInfo(pip).pip_data[pip.index].dst_index);
-        NPNR_ASSERT(wire_to_net[dst] == nullptr || wire_to_net[dst] == net);
-
-        pip_to_net[pip] = net;
-        driving_pip_loc[dst] = std::make_pair(pip.tile % chip_info->width, pip.tile / chip_info->width);
+        auto &wb = wire_bind.at(getFlatWireIndex(dst));
+        NPNR_ASSERT(wb.net == nullptr || (wb.net == net && wb.pip != pip));
 
-        wire_to_net[dst] = net;
+        wb.net = net;
+        wb.pip = pip;
+        wb.driving_pip_tile = pip.tile;
         net->wires[dst].pip = pip;
         net->wires[dst].strength = strength;
         refreshUiPip(pip);
@@ -1142,84 +1306,71 @@ struct Arch : BaseArch<ArchRanges>
     void unbindPip(PipId pip)
     {
         NPNR_ASSERT(pip != PipId());
-        NPNR_ASSERT(pip_to_net[pip] != nullptr);
 
         WireId dst = canonicalWireId(chip_info, pip.tile, locInfo(pip).pip_data[pip.index].dst_index);
-        NPNR_ASSERT(wire_to_net[dst] != nullptr);
-        wire_to_net[dst] = nullptr;
-        pip_to_net[pip]->wires.erase(dst);
+        auto wb = wire_bind.find(getFlatWireIndex(dst));
+        NPNR_ASSERT(wb != nullptr && wb->net != nullptr && wb->pip == pip);
+        wb->net->wires.erase(dst);
 
-        pip_to_net[pip] = nullptr;
+        wb->net = nullptr;
+        wb->pip = PipId();
         refreshUiPip(pip);
         refreshUiWire(dst);
     }
 
-    dict<int, pool<int>> blacklist_pips;
+    // Availability class of each pip, indexed by tile type then pip index. The low nibble is one of
+    // PipAvailClass; for the LUT classes the high nibble holds the LUT eighth the pip belongs to.
+    enum PipAvailClass : uint8_t
+    {
+        PIP_AVAIL_ALWAYS = 0,
+        PIP_AVAIL_NEVER = 1,        // blacklisted, TRIBUF or unsupported routethru
+        PIP_AVAIL_GND_ENTRY = 2,    // site entry to a SITE_GND wire; needs lowest LUTs free
+        PIP_AVAIL_CONST_DRIVER = 3, // needs lowest LUTs free
+        PIP_AVAIL_SITE_VARIANT = 4, // site internal pip of a specific site variant
+        PIP_AVAIL_LUT_PERM = 5,     // needs LUTs in eighth to not be memory/SRL
+        PIP_AVAIL_LUT_THRU = 6,     // needs LUTs in eighth to be free
+    };
+    std::vector<std::vector<uint8_t>> pip_avail_class;
+    void setup_pip_avail();
     void setup_pip_blacklist();
 
+    // Dense wire index: nodes first, then the non-nodal wires of each tile in turn
+    int num_flat_wires = 0;
+    std::vector<int32_t> tile_flat_wire_base;  // num_tiles + 1 entries
+    std::vector<int32_t> tile_flat_rank_base;  // offset of each tile into tile_wire_flat_rank
+    std::vector<int32_t> tile_wire_flat_rank;  // per tile wire covered by tile_wire_to_node; -1 if nodal
+    void setup_flat_wires();
+
+    // Time iteration over the pips of every node, with and without the chipdb node pip index
+    void benchPipIterators();
+
     bool usp_pip_hard_unavail(PipId pip) const
     {
-        if (blacklist_pips.count(locInfo(pip).type) && blacklist_pips.at(locInfo(pip).type).count(pip.index))
+        uint8_t cls = pip_avail_class[chip_info->tile_insts[pip.tile].type][pip.index];
+        if (cls == PIP_AVAIL_ALWAYS)
+            return false;
+        const TileStatus &ts = tileStatus[pip.tile];
+        switch (cls & 0xF) {
+        case PIP_AVAIL_NEVER:
             return true;
-        if (locInfo(pip).pip_data[pip.index].flags == PIP_SITE_ENTRY) {
-            WireId dst = getPipDstWire(pip);
-            if (dst.tile != -1) {
-                auto &wi = wireInfo(dst);
-                if (wi.intent == ID_INTENT_SITE_GND) {
-                    LogicTileStatus *lts = tileStatus[dst.tile].lts;
-                    if (lts != nullptr && (lts->cells[BEL_5LUT] != nullptr || lts->cells[BEL_6LUT] != nullptr))
-                        return true; // Ground driver only available if lowest 5LUT and 6LUT not used
-                }
-            }
-        } else if (locInfo(pip).pip_data[pip.index].flags == PIP_CONST_DRIVER) {
+        case PIP_AVAIL_GND_ENTRY: {
             WireId dst = getPipDstWire(pip);
-            LogicTileStatus *lts = tileStatus[xc7 ? dst.tile : pip.tile].lts;
-            if (lts != nullptr && (lts->cells[BEL_5LUT] != nullptr || lts->cells[BEL_6LUT] != nullptr))
-                return true; // Ground driver only available if lowest 5LUT and 6LUT not used
-        } else if (locInfo(pip).pip_data[pip.index].flags == PIP_SITE_INTERNAL) {
-            auto &pd = locInfo(pip).pip_data[pip.index];
-            if (pd.bel == ID_TRIBUF)
-                return true;
-            if (pd.site >= 0 && pd.site <= int(tileStatus[pip.tile].sitevariant.size()))
-                if (pd.site_variant > 0 && pd.site_variant != tileStatus[pip.tile].sitevariant.at(pd.site))
-                    return true;
-        } else if (locInfo(pip).pip_data[pip.index].flags == PIP_LUT_PERMUTATION) {
-            LogicTileStatus *lts = tileStatus[pip.tile].lts;
-            if (lts == nullptr)
-                return false;
-            int eight = (locInfo(pip).pip_data[pip.index].extra_data >> 8) & 0xF;
-
-            if (((locInfo(pip).pip_data[pip.index].extra_data >> 4) & 0xF) ==
-                (locInfo(pip).pip_data[pip.index].extra_data & 0xF))
-                return false; // from==to, always valid
-
-            const CellInfo *lut6 = lts->cells[(eight << 4) | BEL_6LUT];
-            if (lut6 != nullptr && (lut6->lutInfo.is_memory || lut6->lutInfo.is_srl))
-                return true;
-            const CellInfo *lut5 = lts->cells[(eight << 4) | BEL_5LUT];
-            if (lut5 != nullptr && (lut5->lutInfo.is_memory || lut5->lutInfo.is_srl))
-                return true;
-        } else if (locInfo(pip).pip_data[pip.index].flags == PIP_LUT_ROUTETHRU) {
-            int eight = (locInfo(pip).pip_data[pip.index].extra_data >> 8) & 0xF;
-            int dest = (locInfo(pip).pip_data[pip.index].extra_data) & 0x1;
-            if (eight == 0)
-                return true; // FIXME: conflict with ground
-            if (dest & 0x1)
-                return true; // FIXME: routethru to MUX
-            LogicTileStatus *lts = tileStatus[pip.tile].lts;
-            if (lts == nullptr)
-                return false;
-            const CellInfo *lut6 = lts->cells[(eight << 4) | BEL_6LUT];
-            if (lut6 != nullptr)
-                return true;
-            const CellInfo *lut5 = lts->cells[(eight << 4) | BEL_5LUT];
-            if (lut5 != nullptr)
-                return true;
-        } /*else if (chip_info->tile_types[chip_info->tile_insts[pip.tile].type].type == ID_BRAM) {
+            // Ground driver only available if lowest 5LUT and 6LUT not used
+            return dst.tile != -1 && (tileStatus[dst.tile].lut_used & 0x1);
+        }
+        case PIP_AVAIL_CONST_DRIVER: {
+            int tile = xc7 ? getPipDstWire(pip).tile : pip.tile;
+            return tileStatus[tile].lut_used & 0x1; // Ground driver only available if lowest 5LUT and 6LUT not used
+        }
+        case PIP_AVAIL_SITE_VARIANT: {
             auto &pd = locInfo(pip).pip_data[pip.index];
-            if (pd.site != -1 && pd.site_variant != 0)
-                return true;
-        }*/
+            return pd.site < int(ts.sitevariant.size()) && pd.site_variant != ts.sitevariant.at(pd.site);
+        }
+        case PIP_AVAIL_LUT_PERM:
+            return (ts.lut_mem >> (cls >> 4)) & 0x1;
+        case PIP_AVAIL_LUT_THRU:
+            return (ts.lut_used >> (cls >> 4)) & 0x1;
+        }
         return false;
     }
 
@@ -1228,14 +1379,15 @@ struct Arch : BaseArch<ArchRanges>
         NPNR_ASSERT(pip != PipId());
         if (usp_pip_hard_unavail(pip))
             return false;
-        return pip_to_net.find(pip) == pip_to_net.end() || pip_to_net.at(pip) == nullptr;
+        return getBoundPipNet(pip) == nullptr;
     }
 
     NetInfo *getBoundPipNet(PipId pip) const
     {
         NPNR_ASSERT(pip != PipId());
-        auto p2n = pip_to_net.find(pip);
-        return p2n == pip_to_net.end() ? nullptr : p2n->second;
+        WireId dst = canonicalWireId(chip_info, pip.tile, locInfo(pip).pip_data[pip.index].dst_index);
+        auto wb = wire_bind.find(getFlatWireIndex(dst));
+        return (wb != nullptr && wb->pip == pip) ? wb->net : nullptr;
     }
 
     WireId getConflictingPipWire(PipId pip) const
@@ -1249,9 +1401,7 @@ struct Arch : BaseArch<ArchRanges>
     {
         if (usp_pip_hard_unavail(pip))
             return nullptr;
-        NPNR_ASSERT(pip != PipId());
-        auto p2n = pip_to_net.find(pip);
-        return p2n == pip_to_net.end() ? nullptr : p2n->second;
+        return getBoundPipNet(pip);
     }
 
     AllPipRange getPips() const
@@ -1383,7 +1533,19 @@ struct Arch : BaseArch<ArchRanges>
             return locInfo(wire).wire_data[wire.index].intent;
     }
 
-    DelayQuad getPipDelay(PipId pip) const
+    // The tile of the first tile wire of a node, or the tile of a tile wire
+    int wireAnchorTile(WireId wire) const
+    {
+        return wire.tile == -1 ? chip_info->nodes[wire.index].tile_wires[0].tile : wire.tile;
+    }
+
+    DelayQuad getPipDelay(PipId pip) const { return DelayQuad(pipDelay(pip, /*use_binding=*/true)); }
+
+    // Delay of a pip as if its source wire were unrouted, so it only depends on the chipdb; used by the lookahead
+    delay_t getUnboundPipDelay(PipId pip) const { return pipDelay(pip, /*use_binding=*/false); }
+
+    // With use_binding, the delay grows with the length of the route already driving the source wire
+    delay_t pipDelay(PipId pip, bool use_binding) const
     {
         delay_t delay;
         NPNR_ASSERT(pip != PipId());
@@ -1407,11 +1569,12 @@ struct Arch : BaseArch<ArchRanges>
                 auto &pip_data = locInfo(pip).pip_data[pip.index];
                 auto &pip_timing = chip_info->timing_data->pip_timing_classes[pip_data.timing_class];
                 int src_len = 1;
-                auto found_srcloc = driving_pip_loc.find(getPipSrcWire(pip));
-                if (found_srcloc != driving_pip_loc.end()) {
-                    src_len =
-                            std::max(1, std::abs(found_srcloc->second.first - (pip.tile % chip_info->width)) +
-                                                std::abs(found_srcloc->second.second - (pip.tile / chip_info->width)));
+                auto src_wb = use_binding ? wire_bind.find(getFlatWireIndex(getPipSrcWire(pip))) : nullptr;
+                if (src_wb != nullptr && src_wb->driving_pip_tile != -1) {
+                    int src_x = src_wb->driving_pip_tile % chip_info->width,
+                        src_y = src_wb->driving_pip_tile / chip_info->width;
+                    src_len = std::max(1, std::abs(src_x - (pip.tile % chip_info->width)) +
+                                                  std::abs(src_y - (pip.tile / chip_info->width)));
                 }
                 auto &src_timing =
                         chip_info->timing_data
@@ -1433,13 +1596,20 @@ struct Arch : BaseArch<ArchRanges>
             delay = 300;
         } else
             delay = 25;
-        return DelayQuad(delay);
+        return delay;
     }
 
     DownhillPipRange getPipsDownhill(WireId wire) const
     {
         DownhillPipRange range;
         NPNR_ASSERT(wire != WireId());
+        if (wire.tile == -1 && node_pips != nullptr) {
+            const uint32_t *offset = node_pips->downhill_offset.get();
+            const TilePipRefPOD *pips = node_pips->downhill.get();
+            range.b.csr = pips + offset[wire.index];
+            range.e.csr = pips + offset[wire.index + 1];
+            return range;
+        }
         TileWireRange twr = getTileWireRange(wire);
         range.b.chip = chip_info;
         range.b.twi = twr.b;
@@ -1457,6 +1627,13 @@ struct Arch : BaseArch<ArchRanges>
     {
         UphillPipRange range;
         NPNR_ASSERT(wire != WireId());
+        if (wire.tile == -1 && node_pips != nullptr) {
+            const uint32_t *offset = node_pips->uphill_offset.get();
+            const TilePipRefPOD *pips = node_pips->uphill.get();
+            range.b.csr = pips + offset[wire.index];
+            range.e.csr = pips + offset[wire.index + 1];
+            return range;
+        }
         TileWireRange twr = getTileWireRange(wire);
         range.b.chip = chip_info;
         range.b.twi = twr.b;
@@ -1508,6 +1685,7 @@ struct Arch : BaseArch<ArchRanges>
 
     bool pack();
     bool place();
+    void postLoadPlacement();
     bool route();
     // -------------------------------------------------
 
@@ -1600,7 +1778,42 @@ struct Arch : BaseArch<ArchRanges>
     void routeVcc();
     void routeClock();
     void findSourceSinkLocations();
+    // Only populated by findSourceSinkLocations for chipdbs predating precomputed interconnect locations
     dict<WireId, Loc> sink_locs, source_locs;
+    // Nodes and per-instance tile wires from ChipInfoPOD::int_loc_overrides
+    dict<WireId, Loc> int_loc_overrides;
+
+    // Location of the interconnect tile serving a bel pin wire, if known
+    bool getWireIntLoc(WireId wire, bool is_source, Loc &loc) const
+    {
+        if (chip_info->version < CHIPDB_VERSION_INT_LOCS) {
+            auto &locs = is_source ? source_locs : sink_locs;
+            auto found = locs.find(wire);
+            if (found == locs.end())
+                return false;
+            loc = found->second;
+            return true;
+        }
+        if (wire.tile == -1 && int_loc_overrides.empty())
+            return false;
+        bool per_inst = wire.tile == -1 || (chip_info->version >= CHIPDB_VERSION_INT_LOC_OVERRIDES &&
+                                            locInfo(wire).wire_data[wire.index].int_dx == INT_LOC_PER_INST);
+        if (per_inst) {
+            auto found = int_loc_overrides.find(wire);
+            if (found == int_loc_overrides.end())
+                return false;
+            loc = found->second;
+            return true;
+        }
+        auto &wd = locInfo(wire).wire_data[wire.index];
+        if (wd.int_dx == INT_LOC_NONE)
+            return false;
+        loc = Loc(wire.tile % chip_info->width + wd.int_dx, wire.tile / chip_info->width + wd.int_dy, 0);
+        return true;
+    }
+
+    Lookahead lookahead;
+    void setupLookahead();
     // -------------------------------------------------
 
     void parseXdc(std::istream &file);
@@ -1633,7 +1846,7 @@ struct Arch : BaseArch<ArchRanges>
         return chip_info->tile_types[chip_info->tile_insts[id.tile].type];
     }
     // -------------------------------------------------
-    void writeFasm(const std::string &filename);
+    void writeFasm(const std::string &filename, bool binary = false);
 };
 
 NEXTPNR_NAMESPACE_END
@@ -18,6 +18,7 @@
  */
 
 #include <boost/algorithm/string.hpp>
+#include <mutex>
 #include <queue>
 #include "design_utils.h"
 #include "log.h"
@@ -592,6 +593,9 @@ bool Arch::isBelLocationValid(BelId bel, bool explain_invalid) const
         if (!tileStatus[bel.tile].lts)
             return true;
         LogicTileStatus &lts = *(tileStatus[bel.tile].lts);
+#ifndef NPNR_DISABLE_THREADS
+        std::lock_guard<std::mutex> lock(lts.cache_mutex);
+#endif
         if (xc7)
             return xc7_logic_tile_valid(belTileType, lts);
         else
@@ -905,11 +909,11 @@ void Arch::fixupPlacement()
 
                 if (x_net != nullptr) {
                     WireId x_wire = get_bouncewire(tile, id(std::string("") + char('A' + z) + std::string("X")));
-                    reserved_wires[x_wire] = x_net;
+                    reserved_wires.at(getFlatWireIndex(x_wire)) = x_net;
                 }
                 if (i_net != nullptr) {
                     WireId i_wire = get_bouncewire(tile, id(std::string("") + char('A' + z) + std::string("_I")));
-                    reserved_wires[i_wire] = i_net;
+                    reserved_wires.at(getFlatWireIndex(i_wire)) = i_net;
                 }
             }
         }
@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""
+Runs nextpnr-xilinx on the xilinx/examples designs for a fixed set of seeds and writes per-phase wall times, peak RSS,
+Fmax and wirelength to a JSON file, for comparison with compare.py.
+
+Designs are synthesised once with yosys (using the same commands as the example scripts) and cached in the build
+directory; chipdbs are expected in --chipdb-dir, named as in the example scripts (xc7a35t.bin, xczu2cg.bin, ...).
+
+With --arc-stats, router2 search statistics are recorded too: wires explored, wall time and hardware cache misses per
+routed arc (cache misses need Linux perf events to be permitted, e.g. kernel.perf_event_paranoid <= 2).
+"""
+
+import argparse, datetime, json, os, platform, re, statistics, subprocess, sys, time
+
+bench_dir = os.path.dirname(os.path.abspath(__file__))
+repo_dir = os.path.abspath(os.path.join(bench_dir, "..", ".."))
+examples_dir = os.path.join(repo_dir, "xilinx", "examples")
+
+# name: (example directory, sources, yosys synth command, chipdb, xdc or None)
+designs = {
+	"attosoc": ("attosoc", ["attosoc_top.v", "attosoc.v"],
+		"synth_xilinx -flatten -nobram -top top", "xczu2cg.bin", None),
+	"blinky": ("blinky", ["blinky.v"],
+		"synth_xilinx -flatten -nobram -top top", "xczu2cg.bin", None),
+	"arty-attosoc": ("arty-a35", ["../attosoc/attosoc.v", "attosoc_top.v"],
+		"synth_xilinx -flatten -nowidelut -abc9 -arch xc7 -top top", "xc7a35t.bin", "arty.xdc"),
+	"arty-blinky": ("arty-a35", ["blinky.v"],
+		"synth_xilinx -flatten -abc9 -nobram -arch xc7 -top top", "xc7a35t.bin", "arty.xdc"),
+	"zcu104-blinky": ("zcu104", ["../attosoc/attosoc.v", "blinky.v"],
+		"synth_xilinx -flatten -arch xcup -nobram -top top", "xczu7ev.bin", "zcu104.xdc"),
+}
+
+# Phase times, as logged by nextpnr
+phase_patterns = {
+	"pack": r"Packing time ([0-9.]+)s",
+	"heap": r"HeAP Placer Time: ([0-9.]+)s",
+	"refine": r"Placement refine time ([0-9.]+)s",
+	"route": r"Router[12] time ([0-9.]+)s",
+	"fasm": r"FASM write time ([0-9.]+)s",
+}
+
+# Router2 search statistics, as logged with --router2-perf-profile
+arc_patterns = {
+	"wires_per_arc": r"Router2 searched [0-9]+ arcs, explored [0-9]+ wires \(([0-9.]+) per arc\)",
+	"route_us_per_arc": r"Router2 search time ([0-9.]+)us per arc",
+	"cache_misses_per_arc": r"Router2 search time [0-9.]+us per arc, ([0-9.]+) cache misses per arc",
+}
+
+def synth(name, build_dir, yosys):
+	ex_dir, sources, cmd, _, _ = designs[name]
+	src_paths = [os.path.join(examples_dir, ex_dir, s) for s in sources]
+	out = os.path.join(build_dir, name + ".json")
+	if os.path.exists(out) and all(os.path.getmtime(out) >= os.path.getmtime(s) for s in src_paths):
+		return out
+	print("Synthesising {}...".format(name), flush=True)
+	# Run in the example directory, so $readmemh finds the firmware
+	subprocess.run([yosys, "-q", "-l", os.path.join(build_dir, name + "_yosys.log"), "-p",
+		"{}; write_json {}".format(cmd, out)] + sources, cwd=os.path.join(examples_dir, ex_dir), check=True)
+	return out
+
+def wirelength(routed_json):
+	# Number of wires used by all nets, from the ROUTING attribute of each net ("wire;pip;strength;" per wire)
+	with open(routed_json) as f:
+		netlist = json.load(f)
+	total = 0
+	for mod in netlist["modules"].values():
+		for net in mod.get("netnames", {}).values():
+			routing = net.get("attributes", {}).get("ROUTING", "")
+			total += routing.count(";") // 3
+	return total
+
+def run(name, seed, args, build_dir):
+	ex_dir, _, _, chipdb, xdc = designs[name]
+	prefix = os.path.join(build_dir, "{}_s{}".format(name, seed))
+	cmd = [args.nextpnr, "--chipdb", os.path.join(args.chipdb_dir, chipdb), "--json", synth(name, build_dir, args.yosys),
+		"--seed", str(seed), "--quiet", "--log", prefix + ".log", "--report", prefix + "_report.json",
+		"--write", prefix + "_routed.json", "--fasm", prefix + ".fasm"]
+	if xdc is not None:
+		cmd += ["--xdc", os.path.join(examples_dir, ex_dir, xdc)]
+	if args.arc_stats:
+		cmd += ["--router2-perf-profile"]
+	cmd += args.extra_args.split()
+	print("Running {} seed {}...".format(name, seed), flush=True)
+	start = time.monotonic()
+	proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+	_, status, rusage = os.wait4(proc.pid, 0)
+	wall = time.monotonic() - start
+	result = {"design": name, "seed": seed, "ok": os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0,
+		"wall_s": round(wall, 3), "peak_rss_mb": round(rusage.ru_maxrss / 1024.0, 1), "phases": {}, "fmax_mhz": {},
+		"arc_stats": {}}
+	if os.path.exists(prefix + ".log"):
+		with open(prefix + ".log") as f:
+			log = f.read()
+		for phase, pattern in phase_patterns.items():
+			times = [float(t) for t in re.findall(pattern, log)]
+			if len(times) > 0:
+				result["phases"][phase] = round(sum(times), 3)
+		for stat, pattern in arc_patterns.items():
+			m = re.search(pattern, log)
+			if m is not None:
+				result["arc_stats"][stat] = float(m.group(1))
+	if not result["ok"]:
+		print("  failed, see {}.log".format(prefix))
+		return result
+	with open(prefix + "_report.json") as f:
+		report = json.load(f)
+	for clock, fmax in report.get("fmax", {}).items():
+		result["fmax_mhz"][clock] = round(fmax["achieved"], 2)
+	result["wirelength"] = wirelength(prefix + "_routed.json")
+	return result
+
+def summarise(runs):
+	# Median of each metric over the successful seeds of each design
+	summary = {}
+	for name in sorted(set(r["design"] for r in runs)):
+		ok = [r for r in runs if r["design"] == name and r["ok"]]
+		metrics = {"runs": len(ok), "failed": len([r for r in runs if r["design"] == name and not r["ok"]])}
+		if len(ok) == 0:
+			summary[name] = metrics
+			continue
+		metrics["wall_s"] = statistics.median(r["wall_s"] for r in ok)
+		metrics["peak_rss_mb"] = statistics.median(r["peak_rss_mb"] for r in ok)
+		for phase in phase_patterns:
+			times = [r["phases"][phase] for r in ok if phase in r["phases"]]
+			if len(times) > 0:
+				metrics[phase + "_s"] = statistics.median(times)
+		for stat in arc_patterns:
+			values = [r["arc_stats"][stat] for r in ok if stat in r.get("arc_stats", {})]
+			if len(values) > 0:
+				metrics[stat] = statistics.median(values)
+		fmax = [min(r["fmax_mhz"].values()) for r in ok if len(r["fmax_mhz"]) > 0]
+		if len(fmax) > 0:
+			metrics["fmax_mhz"] = statistics.median(fmax)
+		metrics["wirelength"] = statistics.median(r["wirelength"] for r in ok)
+		summary[name] = metrics
+	return summary
+
+def git_describe():
+	try:
+		return subprocess.run(["git", "describe", "--always", "--dirty"], cwd=repo_dir, capture_output=True,
+			text=True, check=True).stdout.strip()
+	except (OSError, subprocess.CalledProcessError):
+		return None
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument("--nextpnr", help="nextpnr-xilinx binary", default=os.path.join(repo_dir, "nextpnr-xilinx"))
+	parser.add_argument("--chipdb-dir", help="directory containing the chipdb binaries",
+		default=os.path.join(repo_dir, "xilinx"))
+	parser.add_argument("--yosys", help="yosys binary", default="yosys")
+	parser.add_argument("--designs", help="comma-separated designs to run (default: all)", default=",".join(designs))
+	parser.add_argument("--seeds", help="comma-separated placer seeds", default="1,2,3")
+	parser.add_argument("--extra-args", help="extra arguments passed to nextpnr", default="")
+	parser.add_argument("--arc-stats", help="record router2 per-arc search statistics", action="store_true")
+	parser.add_argument("--build-dir", help="directory for netlists and logs", default=os.path.join(bench_dir, "build"))
+	parser.add_argument("--label", help="label stored in the results, e.g. branch name", default="")
+	parser.add_argument("--out", help="results JSON file to write", default="results.json")
+	args = parser.parse_args()
+
+	names = [d for d in args.designs.split(",") if d != ""]
+	for name in names:
+		if name not in designs:
+			sys.exit("unknown design '{}', available: {}".format(name, ", ".join(designs)))
+	seeds = [int(s) for s in args.seeds.split(",") if s != ""]
+	args.build_dir = os.path.abspath(args.build_dir)
+	os.makedirs(args.build_dir, exist_ok=True)
+
+	runs = []
+	for name in names:
+		for seed in seeds:
+			runs.append(run(name, seed, args, args.build_dir))
+	results = {
+		"meta": {
+			"label": args.label,
+			"git": git_describe(),
+			"date": datetime.datetime.now().isoformat(timespec="seconds"),
+			"host": platform.node(),
+			"cpus": os.cpu_count(),
+			"nextpnr": args.nextpnr,
+			"extra_args": args.extra_args,
+			"arc_stats": args.arc_stats,
+			"seeds": seeds,
+		},
+		"runs": runs,
+		"summary": summarise(runs),
+	}
+	with open(args.out, "w") as f:
+		json.dump(results, f, indent=2)
+	print("Wrote {}".format(args.out))
+	if any(not r["ok"] for r in runs):
+		sys.exit(1)
+
+if __name__ == '__main__':
+	main()
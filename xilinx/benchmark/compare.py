@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+Compares two results files written by bench.py, printing the median of each metric per design and the relative change.
+Changes beyond the threshold in the bad direction (slower, more memory, more wire, lower Fmax) are flagged as
+regressions.
+"""
+
+import argparse, json, sys
+
+# metric: True if higher is better
+metrics = {
+	"wall_s": False,
+	"pack_s": False,
+	"heap_s": False,
+	"refine_s": False,
+	"route_s": False,
+	"fasm_s": False,
+	"wires_per_arc": False,
+	"route_us_per_arc": False,
+	"cache_misses_per_arc": False,
+	"peak_rss_mb": False,
+	"wirelength": False,
+	"fmax_mhz": True,
+}
+
+def label(results, filename):
+	meta = results.get("meta", {})
+	return meta.get("label") or meta.get("git") or filename
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__)
+	parser.add_argument("base", help="baseline results JSON")
+	parser.add_argument("new", help="new results JSON")
+	parser.add_argument("--threshold", help="percentage change to flag as a regression", type=float, default=5.0)
+	parser.add_argument("--fail", help="exit with an error if there are regressions", action="store_true")
+	args = parser.parse_args()
+
+	with open(args.base) as f:
+		base = json.load(f)
+	with open(args.new) as f:
+		new = json.load(f)
+	print("base: {}".format(label(base, args.base)))
+	print("new:  {}".format(label(new, args.new)))
+
+	regressions = []
+	for design in sorted(set(base["summary"]) | set(new["summary"])):
+		b = base["summary"].get(design, {})
+		n = new["summary"].get(design, {})
+		print()
+		print("{} ({} vs {} runs{})".format(design, b.get("runs", 0), n.get("runs", 0),
+			", {} failed".format(n["failed"]) if n.get("failed", 0) > 0 else ""))
+		if n.get("failed", 0) > b.get("failed", 0):
+			regressions.append("{}: more failed runs".format(design))
+		for metric, higher_better in metrics.items():
+			if metric not in b and metric not in n:
+				continue
+			if metric not in b or metric not in n:
+				print("  {:<20} {:>12} {:>12}".format(metric, str(b.get(metric, "-")), str(n.get(metric, "-"))))
+				continue
+			bv, nv = b[metric], n[metric]
+			change = 0.0 if bv == 0 else 100.0 * (nv - bv) / bv
+			worse = -change if higher_better else change
+			flag = ""
+			if worse > args.threshold:
+				flag = "  REGRESSION"
+				regressions.append("{}: {} {:+.1f}%".format(design, metric, change))
+			elif worse < -args.threshold:
+				flag = "  improved"
+			print("  {:<20} {:>12.3f} {:>12.3f} {:>+8.1f}%{}".format(metric, bv, nv, change, flag))
+
+	print()
+	if len(regressions) > 0:
+		print("{} regression(s) beyond {:.1f}%:".format(len(regressions), args.threshold))
+		for r in regressions:
+			print("  " + r)
+		if args.fail:
+			sys.exit(1)
+	else:
+		print("No regressions beyond {:.1f}%.".format(args.threshold))
+
+if __name__ == '__main__':
+	main()
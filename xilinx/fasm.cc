@@ -20,7 +20,9 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/reversed.hpp>
+#include <chrono>
 #include <fstream>
+#include "fasm_bin.h"
 #include "log.h"
 #include "nextpnr.h"
 #include "pins.h"
@@ -28,56 +30,221 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 namespace {
+
+// Where features end up; either a text FASM file or the binary format described in fasm_bin.h
+struct FasmWriter
+{
+    virtual ~FasmWriter(){};
+    virtual void write_bit(const std::string &feature) = 0;
+    // Value is LSB first
+    virtual void write_vector(const std::string &feature, const std::vector<bool> &value) = 0;
+    virtual void blank() = 0;
+    virtual void finish(){};
+};
+
+struct TextFasmWriter : FasmWriter
+{
+    std::ostream &out;
+    explicit TextFasmWriter(std::ostream &out) : out(out){};
+
+    void write_bit(const std::string &feature) override { out << feature << '\n'; }
+
+    void write_vector(const std::string &feature, const std::vector<bool> &value) override
+    {
+        out << feature << " = " << int(value.size()) << "'b";
+        for (auto bit : boost::adaptors::reverse(value))
+            out << (bit ? '1' : '0');
+        out << '\n';
+    }
+
+    void blank() override { out << '\n'; }
+
+    void finish() override { out.flush(); }
+};
+
+struct BinaryFasmWriter : FasmWriter
+{
+    std::ostream &out;
+    explicit BinaryFasmWriter(std::ostream &out) : out(out){};
+
+    dict<std::string, uint32_t> string_to_idx;
+    std::vector<uint32_t> string_offsets;
+    std::vector<char> string_data;
+    std::vector<FasmBinRecord> records;
+    std::vector<uint32_t> value_words;
+
+    uint32_t intern(const std::string &str)
+    {
+        auto fnd = string_to_idx.find(str);
+        if (fnd != string_to_idx.end())
+            return fnd->second;
+        uint32_t idx = uint32_t(string_offsets.size());
+        string_offsets.push_back(uint32_t(string_data.size()));
+        string_data.insert(string_data.end(), str.begin(), str.end());
+        string_data.push_back('\0');
+        string_to_idx.emplace(str, idx);
+        return idx;
+    }
+
+    FasmBinRecord &add_record(const std::string &feature)
+    {
+        records.emplace_back();
+        auto &rec = records.back();
+        size_t split = feature.find('.');
+        rec.tile = intern(feature.substr(0, split));
+        rec.feature = intern(split == std::string::npos ? std::string() : feature.substr(split + 1));
+        rec.width = 0;
+        rec.value_index = 0;
+        return rec;
+    }
+
+    void write_bit(const std::string &feature) override { add_record(feature); }
+
+    void write_vector(const std::string &feature, const std::vector<bool> &value) override
+    {
+        auto &rec = add_record(feature);
+        rec.width = uint32_t(value.size());
+        rec.value_index = uint32_t(value_words.size());
+        value_words.resize(value_words.size() + (value.size() + 31) / 32, 0);
+        for (size_t i = 0; i < value.size(); i++)
+            if (value.at(i))
+                value_words.at(rec.value_index + i / 32) |= (1U << (i % 32));
+    }
+
+    void blank() override
+    {
+        records.emplace_back();
+        auto &rec = records.back();
+        rec.tile = FasmBinRecord::kBlank;
+        rec.feature = FasmBinRecord::kBlank;
+        rec.width = 0;
+        rec.value_index = 0;
+    }
+
+    void finish() override
+    {
+        while (string_data.size() % 4 != 0)
+            string_data.push_back('\0');
+        FasmBinHeader hdr;
+        hdr.magic = FasmBinHeader::kMagic;
+        hdr.version = FasmBinHeader::kVersion;
+        hdr.num_strings = uint32_t(string_offsets.size());
+        hdr.string_data_size = uint32_t(string_data.size());
+        hdr.num_records = uint32_t(records.size());
+        hdr.num_value_words = uint32_t(value_words.size());
+        for (uint32_t w : {hdr.magic, hdr.version, hdr.num_strings, hdr.string_data_size, hdr.num_records,
+                           hdr.num_value_words})
+            put_word(w);
+        for (uint32_t w : string_offsets)
+            put_word(w);
+        flush_buffer();
+        out.write(string_data.data(), string_data.size());
+        for (auto &rec : records) {
+            put_word(rec.tile);
+            put_word(rec.feature);
+            put_word(rec.width);
+            put_word(rec.value_index);
+        }
+        for (uint32_t w : value_words)
+            put_word(w);
+        flush_buffer();
+        out.flush();
+    }
+
+    // Words are written byte by byte so the file is little-endian on any host
+    std::vector<char> buffer;
+
+    void put_word(uint32_t w)
+    {
+        buffer.push_back(char(w & 0xFF));
+        buffer.push_back(char((w >> 8) & 0xFF));
+        buffer.push_back(char((w >> 16) & 0xFF));
+        buffer.push_back(char((w >> 24) & 0xFF));
+        if (buffer.size() >= 65536)
+            flush_buffer();
+    }
+
+    void flush_buffer()
+    {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+};
+
 struct FasmBackend
 {
     Context *ctx;
-    std::ostream &out;
+    FasmWriter &out;
     std::vector<std::string> fasm_ctx;
+    // fasm_ctx joined with trailing dots, kept up to date by push/pop
+    std::string prefix;
     dict<int, std::vector<PipId>> pips_by_tile;
 
     dict<IdString, pool<IdString>> invertible_pins;
 
-    FasmBackend(Context *ctx, std::ostream &out) : ctx(ctx), out(out){};
+    FasmBackend(Context *ctx, FasmWriter &out) : ctx(ctx), out(out){};
+
+    void update_prefix()
+    {
+        prefix.clear();
+        for (auto &x : fasm_ctx) {
+            prefix += x;
+            prefix += '.';
+        }
+    }
 
-    void push(const std::string &x) { fasm_ctx.push_back(x); }
+    void push(const std::string &x)
+    {
+        fasm_ctx.push_back(x);
+        prefix += x;
+        prefix += '.';
+    }
 
-    void pop() { fasm_ctx.pop_back(); }
+    void pop()
+    {
+        fasm_ctx.pop_back();
+        update_prefix();
+    }
 
     void pop(int N)
     {
         for (int i = 0; i < N; i++)
             fasm_ctx.pop_back();
+        update_prefix();
     }
     bool last_was_blank = true;
     void blank()
     {
         if (!last_was_blank)
-            out << std::endl;
+            out.blank();
         last_was_blank = true;
     }
 
-    void write_prefix()
+    // Write a feature that isn't relative to the current context
+    void write_feature(const std::string &feature)
     {
-        for (auto &x : fasm_ctx)
-            out << x << ".";
+        out.write_bit(feature);
         last_was_blank = false;
     }
 
     void write_bit(const std::string &name, bool value = true)
     {
         if (value) {
-            write_prefix();
-            out << name << std::endl;
+            out.write_bit(prefix + name);
+            last_was_blank = false;
         }
     }
 
     void write_vector(const std::string &name, const std::vector<bool> &value, bool invert = false)
     {
-        write_prefix();
-        out << name << " = " << int(value.size()) << "'b";
-        for (auto bit : boost::adaptors::reverse(value))
-            out << ((bit ^ invert) ? '1' : '0');
-        out << std::endl;
+        if (invert) {
+            std::vector<bool> inv_value(value);
+            inv_value.flip();
+            out.write_vector(prefix + name, inv_value);
+        } else {
+            out.write_vector(prefix + name, value);
+        }
+        last_was_blank = false;
     }
 
     void write_int_vector(const std::string &name, uint64_t value, int width, bool invert = false)
@@ -240,10 +407,8 @@ struct FasmBackend
                             c.replace(y0pos, 2, "Y1");
                     }
                 }
-                out << tile_name << "." << c << std::endl;
+                write_feature(tile_name + "." + c);
             }
-            if (!pp.empty())
-                last_was_blank = false;
         } else {
             if (pd.extra_data == 1)
                 log_warning("Unprocessed route-thru %s.%s.%s\n!", get_tile_name(pip.tile).c_str(),
@@ -288,9 +453,7 @@ struct FasmBackend
                     return; // missing, not sure if really a ppip?
             }
 
-            out << tile_name << ".";
-            out << dst_name << ".";
-            out << src_name << std::endl;
+            write_feature(tile_name + "." + dst_name + "." + src_name);
 
             if (boost::contains(tile_name, "IOI") && boost::starts_with(dst_name, "IOI_OCLK_")) {
                 dst_name.insert(dst_name.find("OCLK") + 4, 1, 'M');
@@ -298,14 +461,9 @@ struct FasmBackend
 
                 WireId w = ctx->getWireByNameStr(tile_name + "/" + orig_dst_name);
                 NPNR_ASSERT(w != WireId());
-                if (ctx->getBoundWireNet(w) == nullptr) {
-                    out << tile_name << ".";
-                    out << dst_name << ".";
-                    out << src_name << std::endl;
-                }
+                if (ctx->getBoundWireNet(w) == nullptr)
+                    write_feature(tile_name + "." + dst_name + "." + src_name);
             }
-
-            last_was_blank = false;
         }
     };
 
@@ -421,11 +579,7 @@ struct FasmBackend
                         continue;
                 }
 
-                write_prefix();
-                out << belname;
-                if (!skip_pinname)
-                    out << "." << pinname;
-                out << std::endl;
+                write_bit(skip_pinname ? belname : (belname + "." + pinname));
             }
         }
     }
@@ -1569,14 +1723,23 @@ struct FasmBackend
 
 } // namespace
 
-void Arch::writeFasm(const std::string &filename)
+void Arch::writeFasm(const std::string &filename, bool binary)
 {
-    std::ofstream out(filename);
+    std::ofstream out(filename, binary ? (std::ios::out | std::ios::binary) : std::ios::out);
     if (!out)
         log_error("failed to open file %s for writing (%s)\n", filename.c_str(), strerror(errno));
 
-    FasmBackend be(getCtx(), out);
+    auto fasm_start = std::chrono::high_resolution_clock::now();
+    std::unique_ptr<FasmWriter> writer;
+    if (binary)
+        writer.reset(new BinaryFasmWriter(out));
+    else
+        writer.reset(new TextFasmWriter(out));
+    FasmBackend be(getCtx(), *writer);
     be.write_fasm();
+    writer->finish();
+    auto fasm_end = std::chrono::high_resolution_clock::now();
+    log_info("FASM write time %.02fs\n", std::chrono::duration<float>(fasm_end - fasm_start).count());
 }
 
 NEXTPNR_NAMESPACE_END
@@ -0,0 +1,73 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef XILINX_FASM_BIN_H
+#define XILINX_FASM_BIN_H
+
+#include <cstdint>
+
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+/*
+ * Binary FASM, as written by --fasm-bin. All fields are little-endian uint32s, whatever the byte order of the host
+ * that wrote them, and every section is 4-byte aligned, so on little-endian hosts the file can be mmaped and used in
+ * place. The sections, in order, are:
+ *
+ *   FasmBinHeader
+ *   uint32_t string_offsets[num_strings]   offset of each string into string_data
+ *   char string_data[string_data_size]     NUL-terminated strings, zero padded to a multiple of 4 bytes
+ *   FasmBinRecord records[num_records]
+ *   uint32_t value_words[num_value_words]  multi-bit feature values
+ *
+ * Each record is one line of text FASM. Tile names and the remainder of the feature name (after the first '.') are
+ * interned in the string table. A record with width zero is a single bit feature ("TILE.FEATURE"); otherwise the value
+ * is stored LSB first in ceil(width / 32) words starting at value_words[value_index] ("TILE.FEATURE = width'b...").
+ * Records with tile set to kBlank are the blank lines separating groups of features in the text output.
+ *
+ * xilinx/python/fasm_bin2txt.py converts a binary FASM file back to text.
+ */
+
+struct FasmBinHeader
+{
+    static constexpr uint32_t kMagic = 0x4253464e; // "NFSB"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_strings;
+    uint32_t string_data_size;
+    uint32_t num_records;
+    uint32_t num_value_words;
+};
+
+struct FasmBinRecord
+{
+    static constexpr uint32_t kBlank = 0xFFFFFFFF;
+
+    uint32_t tile;
+    uint32_t feature;
+    uint32_t width;
+    uint32_t value_index;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
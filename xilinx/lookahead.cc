@@ -0,0 +1,354 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "lookahead.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <queue>
+
+#include "log.h"
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+constexpr int Lookahead::kMaxDx;
+constexpr int Lookahead::kMaxDy;
+
+namespace {
+// Number of wires of each intent to expand when building the tables
+static constexpr int kNumberSamples = 8;
+// Cap on Dijkstra expansions per sample wire
+static constexpr int kMaxExpansions = 100000;
+// Wires anchored further than this outside the table bounds are not expanded further
+static constexpr int kExploreMargin = 8;
+
+static constexpr uint32_t kFileMagic = 0x414c5858; // "XXLA"
+static constexpr int32_t kFileVersion = 2;
+
+static constexpr delay_t kUnreached = std::numeric_limits<delay_t>::max();
+
+static constexpr int kTableSize = (2 * Lookahead::kMaxDx + 1) * (2 * Lookahead::kMaxDy + 1);
+
+bool is_routing_wire(const Context *ctx, WireId wire) { return wire.tile == -1 || ctx->wireInfo(wire).site == -1; }
+
+std::vector<delay_t> expand_sample(const Context *ctx, WireId src)
+{
+    const int width = ctx->chip_info->width;
+    std::vector<delay_t> result(kTableSize, kUnreached);
+    int src_tile = ctx->wireAnchorTile(src);
+    int sx = src_tile % width, sy = src_tile / width;
+
+    dict<WireId, delay_t> best;
+    std::priority_queue<std::pair<delay_t, WireId>, std::vector<std::pair<delay_t, WireId>>,
+                        std::greater<std::pair<delay_t, WireId>>>
+            queue;
+    best[src] = 0;
+    queue.emplace(0, src);
+
+    int expanded = 0;
+    while (!queue.empty() && expanded < kMaxExpansions) {
+        delay_t cost = queue.top().first;
+        WireId curr = queue.top().second;
+        queue.pop();
+        if (best.at(curr) < cost)
+            continue; // stale queue entry
+        ++expanded;
+        // A wire can be left from any tile it passes through
+        for (WireId tw : ctx->getTileWireRange(curr)) {
+            int dx = (tw.tile % width) - sx, dy = (tw.tile / width) - sy;
+            if (std::abs(dx) > Lookahead::kMaxDx || std::abs(dy) > Lookahead::kMaxDy)
+                continue;
+            delay_t &entry = result.at(Lookahead::table_index(dx, dy));
+            entry = std::min(entry, cost);
+        }
+        int curr_tile = ctx->wireAnchorTile(curr);
+        if (std::abs((curr_tile % width) - sx) > (Lookahead::kMaxDx + kExploreMargin) ||
+            std::abs((curr_tile / width) - sy) > (Lookahead::kMaxDy + kExploreMargin))
+            continue;
+        for (PipId pip : ctx->getPipsDownhill(curr)) {
+            if (ctx->locInfo(pip).pip_data[pip.index].flags != PIP_TILE_ROUTING)
+                continue;
+            WireId next = ctx->getPipDstWire(pip);
+            if (!is_routing_wire(ctx, next))
+                continue;
+            // Pip delays that depend on what is already routed would make the tables depend on when they're built
+            delay_t next_cost = cost + ctx->getUnboundPipDelay(pip) + ctx->getWireDelay(next).maxDelay() +
+                                ctx->getDelayEpsilon();
+            auto fnd = best.find(next);
+            if (fnd != best.end() && fnd->second <= next_cost)
+                continue;
+            best[next] = next_cost;
+            queue.emplace(next_cost, next);
+        }
+    }
+    return result;
+}
+} // namespace
+
+void Lookahead::init(Context *ctx, const std::string &chipdb_hash, const std::string &filename, bool rebuild,
+                     bool write_file)
+{
+    if (ready)
+        return;
+    if (!rebuild && read(chipdb_hash, filename)) {
+        log_info("Loaded router lookahead from %s.\n", filename.c_str());
+    } else {
+        build(ctx);
+        if (write_file)
+            write(chipdb_hash, filename);
+    }
+    ready = true;
+}
+
+std::string Lookahead::build_params(const Context *ctx)
+{
+    return stringf("%d;%d;%d;%d;%d;%d;%d", kFileVersion, kMaxDx, kMaxDy, kNumberSamples, kMaxExpansions,
+                   kExploreMargin, int(ctx->getDelayEpsilon()));
+}
+
+bool Lookahead::lookup(int32_t src_intent, int dx, int dy, delay_t &delay) const
+{
+    auto fnd = intent_to_table.find(src_intent);
+    if (fnd == intent_to_table.end())
+        return false;
+    int cdx = std::max(-kMaxDx, std::min(kMaxDx, dx));
+    int cdy = std::max(-kMaxDy, std::min(kMaxDy, dy));
+    delay = tables.at(fnd->second).at(table_index(cdx, cdy)) + extra_x * std::abs(dx - cdx) +
+            extra_y * std::abs(dy - cdy);
+    return true;
+}
+
+void Lookahead::build(Context *ctx)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    log_info("Building router lookahead...\n");
+
+    const int width = ctx->chip_info->width;
+    const int cx = ctx->chip_info->width / 2, cy = ctx->chip_info->height / 2;
+
+    // Pick the routing wires of each intent closest to the middle of the device, so the tables aren't
+    // truncated by the device edge. Kept as a max-heap on distance.
+    dict<int32_t, std::vector<std::pair<int, WireId>>> samples;
+    for (WireId wire : ctx->getWires()) {
+        if (!is_routing_wire(ctx, wire))
+            continue;
+        int32_t intent = ctx->wireIntent(wire);
+        if (intent == ID_PSEUDO_GND || intent == ID_PSEUDO_VCC)
+            continue;
+        auto dh = ctx->getPipsDownhill(wire);
+        if (!(dh.begin() != dh.end()))
+            continue;
+        int tile = ctx->wireAnchorTile(wire);
+        int dist = std::abs((tile % width) - cx) + std::abs((tile / width) - cy);
+        auto &s = samples[intent];
+        if (int(s.size()) < kNumberSamples) {
+            s.emplace_back(dist, wire);
+            std::push_heap(s.begin(), s.end());
+        } else if (std::make_pair(dist, wire) < s.front()) {
+            std::pop_heap(s.begin(), s.end());
+            s.back() = std::make_pair(dist, wire);
+            std::push_heap(s.begin(), s.end());
+        }
+    }
+
+    std::vector<std::pair<int32_t, WireId>> work;
+    for (auto &s : samples) {
+        std::sort(s.second.begin(), s.second.end());
+        for (auto &entry : s.second)
+            work.emplace_back(s.first, entry.second);
+    }
+
+    std::vector<std::vector<delay_t>> results(work.size());
+#if defined(NPNR_DISABLE_THREADS)
+    for (size_t i = 0; i < work.size(); i++)
+        results.at(i) = expand_sample(ctx, work.at(i).second);
+#else
+    int num_threads = std::max(1, ctx->setting<int>("threads", 8));
+    std::atomic<size_t> next_work(0);
+    std::vector<boost::thread> threads;
+    for (int i = 0; i < num_threads; i++) {
+        threads.emplace_back([&]() {
+            for (size_t j = next_work++; j < work.size(); j = next_work++)
+                results.at(j) = expand_sample(ctx, work.at(j).second);
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+#endif
+
+    // Merge the samples for each intent in a fixed order, so the result doesn't depend on thread scheduling
+    intent_to_table.clear();
+    tables.clear();
+    for (size_t i = 0; i < work.size(); i++) {
+        auto fnd = intent_to_table.find(work.at(i).first);
+        if (fnd == intent_to_table.end()) {
+            intent_to_table[work.at(i).first] = int(tables.size());
+            tables.push_back(std::move(results.at(i)));
+        } else {
+            auto &table = tables.at(fnd->second);
+            for (int j = 0; j < kTableSize; j++)
+                table.at(j) = std::min(table.at(j), results.at(i).at(j));
+        }
+    }
+
+    // Extrapolate beyond the table bounds using the cheapest per-tile cost seen at the far end of any table,
+    // which in practice comes from the long wires.
+    extra_x = std::numeric_limits<delay_t>::max();
+    extra_y = std::numeric_limits<delay_t>::max();
+    for (auto &table : tables) {
+        delay_t half_x = table.at(table_index(kMaxDx / 2, 0)), full_x = table.at(table_index(kMaxDx, 0));
+        if (half_x != kUnreached && full_x != kUnreached && full_x > half_x)
+            extra_x = std::min(extra_x, (full_x - half_x) / (kMaxDx - kMaxDx / 2));
+        delay_t half_y = table.at(table_index(0, kMaxDy / 2)), full_y = table.at(table_index(0, kMaxDy));
+        if (half_y != kUnreached && full_y != kUnreached && full_y > half_y)
+            extra_y = std::min(extra_y, (full_y - half_y) / (kMaxDy - kMaxDy / 2));
+    }
+    if (extra_x == std::numeric_limits<delay_t>::max())
+        extra_x = 10;
+    if (extra_y == std::numeric_limits<delay_t>::max())
+        extra_y = 20;
+    extra_x = std::max<delay_t>(extra_x, 1);
+    extra_y = std::max<delay_t>(extra_y, 1);
+
+    for (auto &table : tables)
+        fill_holes(table);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    log_info("Built lookahead for %d wire intents from %d samples in %.02fs.\n", int(tables.size()), int(work.size()),
+             std::chrono::duration<float>(end - start).count());
+}
+
+void Lookahead::fill_holes(std::vector<delay_t> &table) const
+{
+    // Visit entries in order of increasing Manhattan distance from the origin; so a hole can always be filled from a
+    // neighbour closer to the origin plus the per-tile extrapolation cost
+    if (table.at(table_index(0, 0)) == kUnreached)
+        table.at(table_index(0, 0)) = 0;
+    for (int dist = 1; dist <= kMaxDx + kMaxDy; dist++) {
+        for (int dy = -std::min(dist, kMaxDy); dy <= std::min(dist, kMaxDy); dy++) {
+            int adx = dist - std::abs(dy);
+            if (adx > kMaxDx)
+                continue;
+            for (int dx : {-adx, adx}) {
+                delay_t &entry = table.at(table_index(dx, dy));
+                if (entry == kUnreached) {
+                    if (dx != 0)
+                        entry = std::min(entry, table.at(table_index(dx - (dx > 0 ? 1 : -1), dy)) + extra_x);
+                    if (dy != 0)
+                        entry = std::min(entry, table.at(table_index(dx, dy - (dy > 0 ? 1 : -1))) + extra_y);
+                }
+                if (adx == 0)
+                    break;
+            }
+        }
+    }
+}
+
+bool Lookahead::read(const std::string &chipdb_hash, const std::string &filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+        return false;
+    // Little-endian regardless of the host, so cache directories can be shared
+    auto read_i32 = [&]() {
+        unsigned char bytes[4] = {0, 0, 0, 0};
+        in.read(reinterpret_cast<char *>(bytes), sizeof(bytes));
+        return int32_t(uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) | (uint32_t(bytes[2]) << 16) |
+                       (uint32_t(bytes[3]) << 24));
+    };
+    uint32_t magic = uint32_t(read_i32());
+    int32_t version = read_i32();
+    if (!in || magic != kFileMagic || version != kFileVersion)
+        return false;
+    int32_t hash_len = read_i32();
+    if (!in || hash_len < 0 || hash_len > 1024)
+        return false;
+    std::string file_hash(hash_len, '\0');
+    in.read(&file_hash[0], hash_len);
+    if (!in || file_hash != chipdb_hash) {
+        log_info("Router lookahead %s does not match chipdb, rebuilding.\n", filename.c_str());
+        return false;
+    }
+    int32_t max_dx = read_i32(), max_dy = read_i32();
+    if (!in || max_dx != kMaxDx || max_dy != kMaxDy)
+        return false;
+    extra_x = read_i32();
+    extra_y = read_i32();
+    int32_t num_tables = read_i32();
+    if (!in || num_tables < 0)
+        return false;
+    intent_to_table.clear();
+    tables.clear();
+    for (int32_t i = 0; i < num_tables; i++) {
+        int32_t intent = read_i32();
+        intent_to_table[intent] = int(tables.size());
+        tables.emplace_back(kTableSize);
+        for (auto &entry : tables.back())
+            entry = read_i32();
+    }
+    if (!in) {
+        intent_to_table.clear();
+        tables.clear();
+        return false;
+    }
+    return true;
+}
+
+void Lookahead::write(const std::string &chipdb_hash, const std::string &filename) const
+{
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        log_warning("Failed to open router lookahead %s for writing.\n", filename.c_str());
+        return;
+    }
+    std::vector<char> buf;
+    auto write_i32 = [&](int32_t value) {
+        uint32_t bits = uint32_t(value);
+        for (int i = 0; i < 4; i++)
+            buf.push_back(char((bits >> (8 * i)) & 0xFF));
+    };
+    write_i32(int32_t(kFileMagic));
+    write_i32(kFileVersion);
+    write_i32(int32_t(chipdb_hash.size()));
+    buf.insert(buf.end(), chipdb_hash.begin(), chipdb_hash.end());
+    write_i32(kMaxDx);
+    write_i32(kMaxDy);
+    write_i32(extra_x);
+    write_i32(extra_y);
+    write_i32(int32_t(tables.size()));
+    // Write in intent order, so the file is reproducible
+    std::vector<std::pair<int32_t, int>> order(intent_to_table.begin(), intent_to_table.end());
+    std::sort(order.begin(), order.end());
+    for (auto &entry : order) {
+        write_i32(entry.first);
+        for (delay_t delay : tables.at(entry.second))
+            write_i32(int32_t(delay));
+    }
+    out.write(buf.data(), buf.size());
+    if (!out)
+        log_warning("Failed to write router lookahead %s.\n", filename.c_str());
+    else
+        log_info("Wrote router lookahead to %s.\n", filename.c_str());
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,83 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef XILINX_LOOKAHEAD_H
+#define XILINX_LOOKAHEAD_H
+
+#include <string>
+#include <vector>
+
+#include "archdefs.h"
+#include "hashlib.h"
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+struct Context;
+
+// Router lookahead built from the chipdb routing graph.
+//
+// For every wire intent that appears on general (non-site) routing, a handful
+// of sample wires near the middle of the device are expanded with Dijkstra
+// over tile routing pips. The cheapest cost to reach any tile wire at each
+// (dx, dy) tile delta from the sample's anchor tile is recorded, giving one
+// cost table per intent. The anchor of a wire is the tile of its first tile
+// wire, which is cheap to compute at query time and consistent with how the
+// tables were built.
+//
+// As building the tables takes a while on the large parts, they are written
+// to a per-user cache directory, tagged with a key derived from the whole
+// chipdb and build_params() so a stale file isn't used. The file is always
+// little-endian.
+struct Lookahead
+{
+    // Maximum tile delta stored in the tables, larger deltas are extrapolated
+    static constexpr int kMaxDx = 32;
+    static constexpr int kMaxDy = 32;
+
+    void init(Context *ctx, const std::string &chipdb_hash, const std::string &filename, bool rebuild,
+              bool write_file);
+
+    bool is_ready() const { return ready; }
+
+    // Everything besides the chipdb that affects the table contents, for the cache key
+    static std::string build_params(const Context *ctx);
+
+    // Returns false if there is no table for this intent
+    bool lookup(int32_t src_intent, int dx, int dy, delay_t &delay) const;
+
+    static int table_index(int dx, int dy) { return (dy + kMaxDy) * (2 * kMaxDx + 1) + (dx + kMaxDx); }
+
+  private:
+    bool ready = false;
+    // Per-tile delays used to extrapolate beyond the table bounds
+    delay_t extra_x = 10, extra_y = 20;
+
+    dict<int32_t, int> intent_to_table;
+    std::vector<std::vector<delay_t>> tables;
+
+    void build(Context *ctx);
+    void fill_holes(std::vector<delay_t> &table) const;
+    bool read(const std::string &chipdb_hash, const std::string &filename);
+    void write(const std::string &chipdb_hash, const std::string &filename) const;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
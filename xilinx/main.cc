@@ -34,7 +34,7 @@ class UspCommandHandler : public CommandHandler
     UspCommandHandler(int argc, char **argv);
     virtual ~UspCommandHandler(){};
     std::unique_ptr<Context> createContext(dict<std::string, Property> &values) override;
-    void setupArchContext(Context *ctx) override{};
+    void setupArchContext(Context *ctx) override;
     void customBitstream(Context *ctx) override;
     void customAfterLoad(Context *ctx) override;
 
@@ -50,6 +50,15 @@ po::options_description UspCommandHandler::getArchOptions()
     specific.add_options()("chipdb", po::value<std::string>(), "name of chip database binary");
     specific.add_options()("xdc", po::value<std::vector<std::string>>(), "XDC-style constraints file");
     specific.add_options()("fasm", po::value<std::string>(), "fasm bitstream file to write");
+    specific.add_options()("fasm-bin", po::value<std::string>(),
+                           "binary fasm file to write (see xilinx/python/fasm_bin2txt.py to convert to text)");
+    specific.add_options()("no-lookahead", "use the simple distance-based delay estimate instead of the lookahead");
+    specific.add_options()("rebuild-lookahead", "ignore any cached router lookahead and rebuild it");
+    specific.add_options()("dont-write-lookahead", "don't write the router lookahead to the cache directory");
+    specific.add_options()("lookahead-cache-dir", po::value<std::string>(),
+                           "directory for cached router lookaheads (default: $XDG_CACHE_HOME/nextpnr-xilinx)");
+    specific.add_options()("no-node-pip-index", "ignore the chipdb node pip index and walk node tile wires instead");
+    specific.add_options()("bench-pip-iter", "time iterating the uphill and downhill pips of every node");
 
     return specific;
 }
@@ -60,6 +69,10 @@ void UspCommandHandler::customBitstream(Context *ctx)
         std::string filename = vm["fasm"].as<std::string>();
         ctx->writeFasm(filename);
     }
+    if (vm.count("fasm-bin")) {
+        std::string filename = vm["fasm-bin"].as<std::string>();
+        ctx->writeFasm(filename, /*binary=*/true);
+    }
 }
 
 std::unique_ptr<Context> UspCommandHandler::createContext(dict<std::string, Property> &values)
@@ -69,9 +82,21 @@ std::unique_ptr<Context> UspCommandHandler::createContext(dict<std::string, Prop
         log_error("chip database binary must be provided\n");
     }
     chipArgs.chipdb = vm["chipdb"].as<std::string>();
+    chipArgs.disable_lookahead = vm.count("no-lookahead") != 0;
+    chipArgs.rebuild_lookahead = vm.count("rebuild-lookahead") != 0;
+    chipArgs.dont_write_lookahead = vm.count("dont-write-lookahead") != 0;
+    if (vm.count("lookahead-cache-dir"))
+        chipArgs.lookahead_cache_dir = vm["lookahead-cache-dir"].as<std::string>();
+    chipArgs.disable_node_pip_index = vm.count("no-node-pip-index") != 0;
     return std::unique_ptr<Context>(new Context(chipArgs));
 }
 
+void UspCommandHandler::setupArchContext(Context *ctx)
+{
+    if (vm.count("bench-pip-iter"))
+        ctx->benchPipIterators();
+}
+
 void UspCommandHandler::customAfterLoad(Context *ctx)
 {
     if (vm.count("xdc")) {
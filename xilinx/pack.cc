@@ -20,6 +20,7 @@
 #include "pack.h"
 #include <algorithm>
 #include <boost/optional.hpp>
+#include <chrono>
 #include <iterator>
 #include <queue>
 #include <unordered_set>
@@ -883,6 +884,7 @@ void XilinxPacker::pack_inverters()
 
 bool Arch::pack()
 {
+    auto pack_start = std::chrono::high_resolution_clock::now();
     if (xc7) {
         XC7Packer packer;
         packer.ctx = getCtx();
@@ -932,6 +934,8 @@ bool Arch::pack()
     assignArchInfo();
     attrs[id_step] = std::string("pack");
     archInfoToAttributes();
+    auto pack_end = std::chrono::high_resolution_clock::now();
+    log_info("Packing time %.02fs\n", std::chrono::duration<float>(pack_end - pack_start).count());
     return true;
 }
 
@@ -4,6 +4,140 @@ import sys, argparse
 import bels, constid
 from nextpnr_structs import *
 import os
+import collections
+
+logic_tile_types = ("CLBLL_L", "CLBLL_R", "CLBLM_L", "CLBLM_R", "CLEL_L", "CLEL_R", "CLEM", "CLEM_R")
+int_tile_types = ("INT", "INT_L", "INT_R")
+bram_tile_types = ("BRAM", "BRAM_L", "BRAM_R")
+
+# Find the interconnect tile serving each bel pin wire, so nextpnr doesn't have to search for it at route time. This is
+# a best-effort search of up to 500 steps from the pin to the first general routing wire: uphill for input pins and
+# downhill for output pins. The wires on the path found also get that interconnect tile, as they did in the runtime
+# search this replaces, as long as no earlier search got to them first. Logic tiles are skipped as they always sit next
+# to their INT tile, and so are xc7 BRAM input pins. Every tile instance is searched, as instances of the same type
+# near the edge of the device or next to hard blocks don't always reach the same interconnect tile.
+# Returns {search vertex key: (first member tile wire, (INT x, INT y) or None)}.
+def find_int_locs(d, tile_types, tile_type_index, xc7):
+	sink_skip = set(constid.make(x) for x in ("NODE_PINFEED", "PSEUDO_VCC", "PSEUDO_GND", "INTENT_DEFAULT",
+		"NODE_DEDICATED", "NODE_OPTDELAY", "PINFEED", "INPUT"))
+	source_skip = set(constid.make(x) for x in ("NODE_PINFEED", "PSEUDO_VCC", "PSEUDO_GND", "INTENT_DEFAULT",
+		"NODE_DEDICATED", "NODE_OPTDELAY", "NODE_OUTPUT", "NODE_INT_INTERFACE"))
+	# A search vertex is a nextpnr wire: either a whole multi-wire node or a single tile wire. Returns
+	# (key, member tile wires, intent, is site wire, anchor tile), or None for the constant networks.
+	def vertex(t, wi):
+		nw = tile_types[tile_type_index[t.tile_type()]].wires[wi]
+		if not nw.is_site and wi < len(t.data.wires):
+			n = Wire(t, wi).node()
+			if n.is_gnd() or n.is_vcc():
+				return None
+			if len(n.wires) > 1:
+				# Matches the node export below, where interconnect tile wires come first
+				anchor = next((x.tile for x in n.wires if x.tile.tile_type() in int_tile_types), n.wires[0].tile)
+				return (("n", n.unique_index()), [(x.tile, x.index) for x in n.wires],
+					constid.make(n.wires[0].intent()), False, anchor)
+		return (("w", t.x, t.y, wi), [(t, wi)], nw.intent, nw.is_site, t)
+	# Returns the anchor tile of the general routing wire found and the vertices before it, starting with the pin
+	def search(start, uphill):
+		skip = sink_skip if uphill else source_skip
+		parent = {start[0]: None}
+		queue = collections.deque([start])
+		iters = 0
+		while len(queue) > 0 and iters < 500:
+			iters += 1
+			v = queue.popleft()
+			key, members, intent, is_site, anchor = v
+			if not is_site and intent not in skip:
+				path = []
+				cursor = parent[key]
+				while cursor is not None:
+					path.append(cursor)
+					cursor = parent[cursor[0]]
+				return anchor, path[::-1]
+			for t, mwi in members:
+				mtt = tile_types[tile_type_index[t.tile_type()]]
+				mw = mtt.wires[mwi]
+				for pi in (mw.pips_uh if uphill else mw.pips_dh):
+					p = mtt.pips[pi]
+					nv = vertex(t, p.from_wire if uphill else p.to_wire)
+					if nv is None or nv[0] in parent:
+						continue
+					parent[nv[0]] = v
+					queue.append(nv)
+		return None, []
+	# Input (or bidirectional) pins search uphill like sinks, output pins downhill like sources
+	pin_dirs = {}
+	for tt in tile_types:
+		pin_dir = {}
+		for b in tt.bels:
+			for bw in b.belports:
+				if bw.port_type != 1 or bw.wire not in pin_dir:
+					pin_dir[bw.wire] = bw.port_type
+		pin_dirs[tt.index] = pin_dir
+	locs = {}
+	paths = []
+	for tile in d.tiles:
+		if tile.tile_type() in logic_tile_types:
+			continue
+		skip_sinks = xc7 and tile.tile_type() in bram_tile_types
+		for wi, port_type in pin_dirs[tile_type_index[tile.tile_type()]].items():
+			if port_type != 1 and skip_sinks:
+				continue
+			start = vertex(tile, wi)
+			if start is None or start[0] in locs:
+				continue
+			anchor, path = search(start, port_type != 1)
+			int_xy = (anchor.x, anchor.y) if anchor is not None else None
+			locs[start[0]] = (start[1][0], int_xy)
+			paths.append((path, int_xy))
+	# Pins take priority over path wires, then the first search to reach a wire wins
+	for path, int_xy in paths:
+		for key, members, intent, is_site, anchor in path[1:]:
+			if key not in locs:
+				locs[key] = (members[0], int_xy)
+	return locs
+
+# Split the interconnect locations found by find_int_locs into the per-tile-type offsets in TileWireInfoPOD and the
+# per-instance table for nodes and for tile wires whose offset isn't the same in every instance of the tile type.
+# Must be called once nodes have been exported. Returns a sorted list of (tile or -1 for nodes, wire or node index,
+# INT x, INT y).
+def split_int_locs(d, locs, tile_types, tile_insts):
+	overrides = []
+	tile_locs = {}
+	for (t, wi), int_xy in locs.values():
+		if int_xy is None:
+			continue
+		tileidx = t.y * d.width + t.x
+		node = tile_insts[tileidx].tilewire_to_node[wi]
+		if node != -1:
+			overrides.append((-1, node, int_xy[0], int_xy[1]))
+		else:
+			tile_locs[tileidx, wi] = int_xy
+	for tt in tile_types:
+		for w in tt.wires:
+			w.int_offset = None
+	tiles_of_type = collections.defaultdict(list)
+	for ti in tile_insts:
+		tiles_of_type[ti.tile_type].append(ti.index)
+	for tt_index, wi in sorted(set((tile_insts[tileidx].tile_type, wi) for tileidx, wi in tile_locs.keys())):
+		offsets = {}
+		for tileidx in tiles_of_type[tt_index]:
+			if tile_insts[tileidx].tilewire_to_node[wi] != -1:
+				continue
+			int_xy = tile_locs.get((tileidx, wi))
+			offsets[tileidx] = None
+			if int_xy is not None:
+				dx, dy = int_xy[0] - tileidx % d.width, int_xy[1] - tileidx // d.width
+				if -127 < dx < 128 and -127 < dy < 128:
+					offsets[tileidx] = (dx, dy)
+		if len(set(offsets.values())) == 1:
+			tile_types[tt_index].wires[wi].int_offset = next(iter(offsets.values()))
+			continue
+		tile_types[tt_index].wires[wi].int_offset = "per_inst"
+		for tileidx in tiles_of_type[tt_index]:
+			int_xy = tile_locs.get((tileidx, wi))
+			if tileidx in offsets and int_xy is not None:
+				overrides.append((tileidx, wi, int_xy[0], int_xy[1]))
+	return sorted(overrides)
 
 def main():
 
@@ -15,6 +149,7 @@ def main():
 	parser.add_argument("--device", help="name of device to export", type=str, required=True)
 	parser.add_argument("--constids", help="name of nextpnr constids file to read", type=str, default=os.path.join(rwbase, "constids.inc"))
 	parser.add_argument("--bba", help="bba file to write", type=str, required=True)
+	parser.add_argument("--node-pip-index", help="include a per-node pip index for faster routing (larger chipdb)", action="store_true")
 	args = parser.parse_args()
 	# Read baked-in constids
 	with open(args.constids, "r") as cf:
@@ -62,6 +197,9 @@ def main():
 			nti.tilewire_to_node = [-1] * tile_types[nti.tile_type].tile_wire_count
 			tile_insts.append(nti)
 
+	print("Finding bel pin interconnect locations...")
+	int_locs = find_int_locs(d, tile_types, tile_type_index, args.device.startswith("xc7"))
+
 	# Begin writing bba
 	with open(args.bba, "w") as bbaf:
 		bba = BBAWriter(bbaf)
@@ -79,92 +217,13 @@ def main():
 		bba.u32(constid.num_base_ids)
 		bba.u32(len(constid.constids) - constid.num_base_ids)
 		bba.ref('extra_constid_strs')
-		print("Exporting tile and site type data...")
-		for tt in tile_types:
-			# List of wires on bels in tile
-			for bel in tt.bels:
-				bba.label('t{}b{}_wires'.format(tt.index, bel.index))
-				for bw in bel.belports:
-					bba.u32(bw.name) # port name
-					bba.u32(bw.port_type) # port type
-					bba.u32(bw.wire) # index of connected tile wire
-			# List of uphill pips, downhill pips and bel ports on wires in tile
-			for w in tt.wires:
-				bba.label('t{}w{}_uh'.format(tt.index, w.index))
-				for uh in w.pips_uh:
-					bba.u32(uh) # index of uphill pip
-				bba.label('t{}w{}_dh'.format(tt.index, w.index))
-				for dh in w.pips_dh:
-					bba.u32(dh) # index of uphill pip
-				bba.label('t{}w{}_bels'.format(tt.index, w.index))
-				for bp in w.belpins:
-					bba.u32(bp.bel) # index of bel in tile
-					bba.u32(bp.port) # bel port constid
-			# Bel data for tiletype
-			bba.label('t{}_bels'.format(tt.index))
-			for b in tt.bels:
-				bba.u32(b.name) # name constid
-				bba.u32(b.bel_type) # type (compatible type for nextpnr) constid
-				bba.u32(b.native_type) # native type (original type in RapidWright) constid
-				timing_inst_idx = -1
-				if tt.type in timing.tile_type_to_tile_index:
-					ttmg = timing.tiles[timing.tile_type_to_tile_index[tt.type]]
-					bel_name_inst = constid.make(b.site_type + "/" + constid.constids[b.name])
-					site_inst = constid.make(b.site_type)
-					if bel_name_inst in ttmg.instance_name_to_index:
-						timing_inst_idx = ttmg.instance_name_to_index[bel_name_inst]
-					elif site_inst in ttmg.instance_name_to_index:
-						timing_inst_idx = ttmg.instance_name_to_index[site_inst]
-				bba.u32(timing_inst_idx) # timing instance index
-				bba.u32(len(b.belports)) # number of bel port wires
-				bba.ref("t{}b{}_wires".format(tt.index, b.index)) # ref to list of bel wires
-				bba.u16(b.z) # bel z position
-				bba.u16(b.site) # bel site index in tile
-				bba.u16(b.site_variant) # bel site variant index
-				bba.u16(b.is_routing) # 1 if bel is a routing bel
-			# Wire data for tiletype
-			bba.label('t{}_wires'.format(tt.index))
-			for w in tt.wires:
-				bba.u32(w.name) # name constid
-				bba.u32(len(w.pips_uh)) # number of uphill pips
-				bba.u32(len(w.pips_dh)) # number of downhill pips
-				bba.u32(w.timing_class) # timing class index
-				bba.ref("t{}w{}_uh".format(tt.index, w.index)) # ref to list of uphill pip indices
-				bba.ref("t{}w{}_dh".format(tt.index, w.index)) # ref to list of downhill pip indices
-				bba.u32(len(w.belpins)) # number of bel pins on wire
-				bba.ref("t{}w{}_bels".format(tt.index, w.index)) # ref to list of bel pins
-				bba.u16(w.site if w.is_site else -1) # wire site index in tile if a site wire, else -1 if a tile wire
-				bba.u16(0) # padding
-				bba.u32(w.intent) # wire intent constid
-			# Pip data for tiletype
-			bba.label('t{}_pips'.format(tt.index))
-			for p in tt.pips:
-				bba.u32(p.from_wire) # src tile wire index
-				bba.u32(p.to_wire) # dst tile wire index
-				bba.u32(p.timing_class) # pip timing class
-				bba.u16(0) # padding
-				bba.u16(p.pip_type.value)
-				bba.u32(p.bel) # bel name constid for site pips
-				bba.u32(p.extra_data) # misc extra data for pseudo-pips (e.g lut permutation info)
-				bba.u16(p.site) # site index in tile for site pips
-				bba.u16(p.site_variant) # site variant index for site pips
-		# Per-tile-type data including references to the above lists of objects
-		bba.label("tiletype_data")
-		for tt in tile_types:
-			bba.u32(tt.type) # tile type constid
-			bba.u32(len(tt.bels)) # number of bels
-			bba.ref("t{}_bels".format(tt.index)) # ref to list of bels
-			bba.u32(len(tt.wires)) # number of wires
-			bba.ref("t{}_wires".format(tt.index)) # ref to list of wires
-			bba.u32(len(tt.pips)) # number of pips
-			bba.ref("t{}_pips".format(tt.index)) # ref to list of pips
-			bba.u32(timing.tile_type_to_tile_index[tt.type] if tt.type in timing.tile_type_to_tile_index else -1) # tile cell timing data index
 		print("Exporting nodes...")
 		seen_nodes = set()
 		curr = 0
 		total = len(d.tiles)
 		node_wire_count = []
 		node_intent = []
+		node_tile_wires = [] # (tile index, wire index) list for each node, in exported order
 		for row in range(d.height):
 			gnd_nodes = []
 			vcc_nodes = []
@@ -194,6 +253,7 @@ def main():
 					if len(n.wires) > 1:
 						# List of tile wires in node
 						bba.label("n{}_tw".format(len(node_wire_count)))
+						node_tile_wires.append([])
 						# Add interconnect tiles first for better delay estimates in nextpnr
 						for j in range(2):
 							for w in n.wires:
@@ -203,18 +263,21 @@ def main():
 								bba.u32(tileidx) # tile index
 								bba.u32(w.index) # wire index in tile
 								tile_insts[tileidx].tilewire_to_node[w.index] = len(node_wire_count)
+								node_tile_wires[-1].append((tileidx, w.index))
 						node_intent.append(constid.make(n.wires[0].intent()))
 						node_wire_count.append(len(n.wires))
 			# Connect up row and column ground nodes
 			for i in range(2):
 				wire_count = 0
 				bba.label("n{}_tw".format(len(node_wire_count)))
+				node_tile_wires.append([])
 				for n in (vcc_nodes if i == 1 else gnd_nodes):
 					for w in n.wires:
 						tileidx = w.tile.y * d.width + w.tile.x
 						bba.u32(tileidx) # tile index
 						bba.u32(w.index) # wire index in tile
 						tile_insts[tileidx].tilewire_to_node[w.index] = len(node_wire_count)
+						node_tile_wires[-1].append((tileidx, w.index))
 						wire_count += 1
 				for col in range(d.width):
 					t = d.tiles_by_xy[col, row]
@@ -223,6 +286,7 @@ def main():
 					wire_idx = tile_types[tile_insts[tileidx].tile_type].row_vcc_wire_index if i == 1 else tile_types[tile_insts[tileidx].tile_type].row_gnd_wire_index
 					bba.u32(wire_idx)
 					tile_insts[tileidx].tilewire_to_node[wire_idx] = len(node_wire_count)
+					node_tile_wires[-1].append((tileidx, wire_idx))
 					wire_count += 1
 				node_wire_count.append(wire_count)
 				node_intent.append(constid.make("PSEUDO_VCC" if i == 1 else "PSEUDO_GND"))
@@ -230,6 +294,7 @@ def main():
 		for i in range(2):
 			wire_count = 0
 			bba.label("n{}_tw".format(len(node_wire_count)))
+			node_tile_wires.append([])
 			for row in range(d.height):
 				t = d.tiles_by_xy[0, row]
 				tileidx = row * d.width
@@ -237,9 +302,99 @@ def main():
 				wire_idx = tile_types[tile_insts[tileidx].tile_type].global_vcc_wire_index if i == 1 else tile_types[tile_insts[tileidx].tile_type].global_gnd_wire_index
 				bba.u32(wire_idx)
 				tile_insts[tileidx].tilewire_to_node[wire_idx] = len(node_wire_count)
+				node_tile_wires[-1].append((tileidx, wire_idx))
 				wire_count += 1
 			node_wire_count.append(wire_count)
 			node_intent.append(constid.make("PSEUDO_VCC" if i == 1 else "PSEUDO_GND"))
+		# Tile wire interconnect offsets depend on which tile wires are part of nodes
+		int_loc_overrides = split_int_locs(d, int_locs, tile_types, tile_insts)
+		print("Exporting tile and site type data...")
+		for tt in tile_types:
+			# List of wires on bels in tile
+			for bel in tt.bels:
+				bba.label('t{}b{}_wires'.format(tt.index, bel.index))
+				for bw in bel.belports:
+					bba.u32(bw.name) # port name
+					bba.u32(bw.port_type) # port type
+					bba.u32(bw.wire) # index of connected tile wire
+			# List of uphill pips, downhill pips and bel ports on wires in tile
+			for w in tt.wires:
+				bba.label('t{}w{}_uh'.format(tt.index, w.index))
+				for uh in w.pips_uh:
+					bba.u32(uh) # index of uphill pip
+				bba.label('t{}w{}_dh'.format(tt.index, w.index))
+				for dh in w.pips_dh:
+					bba.u32(dh) # index of uphill pip
+				bba.label('t{}w{}_bels'.format(tt.index, w.index))
+				for bp in w.belpins:
+					bba.u32(bp.bel) # index of bel in tile
+					bba.u32(bp.port) # bel port constid
+			# Bel data for tiletype
+			bba.label('t{}_bels'.format(tt.index))
+			for b in tt.bels:
+				bba.u32(b.name) # name constid
+				bba.u32(b.bel_type) # type (compatible type for nextpnr) constid
+				bba.u32(b.native_type) # native type (original type in RapidWright) constid
+				timing_inst_idx = -1
+				if tt.type in timing.tile_type_to_tile_index:
+					ttmg = timing.tiles[timing.tile_type_to_tile_index[tt.type]]
+					bel_name_inst = constid.make(b.site_type + "/" + constid.constids[b.name])
+					site_inst = constid.make(b.site_type)
+					if bel_name_inst in ttmg.instance_name_to_index:
+						timing_inst_idx = ttmg.instance_name_to_index[bel_name_inst]
+					elif site_inst in ttmg.instance_name_to_index:
+						timing_inst_idx = ttmg.instance_name_to_index[site_inst]
+				bba.u32(timing_inst_idx) # timing instance index
+				bba.u32(len(b.belports)) # number of bel port wires
+				bba.ref("t{}b{}_wires".format(tt.index, b.index)) # ref to list of bel wires
+				bba.u16(b.z) # bel z position
+				bba.u16(b.site) # bel site index in tile
+				bba.u16(b.site_variant) # bel site variant index
+				bba.u16(b.is_routing) # 1 if bel is a routing bel
+			# Wire data for tiletype
+			bba.label('t{}_wires'.format(tt.index))
+			for w in tt.wires:
+				bba.u32(w.name) # name constid
+				bba.u32(len(w.pips_uh)) # number of uphill pips
+				bba.u32(len(w.pips_dh)) # number of downhill pips
+				bba.u32(w.timing_class) # timing class index
+				bba.ref("t{}w{}_uh".format(tt.index, w.index)) # ref to list of uphill pip indices
+				bba.ref("t{}w{}_dh".format(tt.index, w.index)) # ref to list of downhill pip indices
+				bba.u32(len(w.belpins)) # number of bel pins on wire
+				bba.ref("t{}w{}_bels".format(tt.index, w.index)) # ref to list of bel pins
+				bba.u16(w.site if w.is_site else -1) # wire site index in tile if a site wire, else -1 if a tile wire
+				if w.int_offset is None:
+					int_dx, int_dy = (-128, -128)
+				elif w.int_offset == "per_inst":
+					int_dx, int_dy = (-127, -127)
+				else:
+					int_dx, int_dy = w.int_offset
+				bba.u8(int_dx & 0xFF) # X offset to interconnect tile, -128 if unknown, -127 if per instance
+				bba.u8(int_dy & 0xFF) # Y offset to interconnect tile, -128 if unknown, -127 if per instance
+				bba.u32(w.intent) # wire intent constid
+			# Pip data for tiletype
+			bba.label('t{}_pips'.format(tt.index))
+			for p in tt.pips:
+				bba.u32(p.from_wire) # src tile wire index
+				bba.u32(p.to_wire) # dst tile wire index
+				bba.u32(p.timing_class) # pip timing class
+				bba.u16(0) # padding
+				bba.u16(p.pip_type.value)
+				bba.u32(p.bel) # bel name constid for site pips
+				bba.u32(p.extra_data) # misc extra data for pseudo-pips (e.g lut permutation info)
+				bba.u16(p.site) # site index in tile for site pips
+				bba.u16(p.site_variant) # site variant index for site pips
+		# Per-tile-type data including references to the above lists of objects
+		bba.label("tiletype_data")
+		for tt in tile_types:
+			bba.u32(tt.type) # tile type constid
+			bba.u32(len(tt.bels)) # number of bels
+			bba.ref("t{}_bels".format(tt.index)) # ref to list of bels
+			bba.u32(len(tt.wires)) # number of wires
+			bba.ref("t{}_wires".format(tt.index)) # ref to list of wires
+			bba.u32(len(tt.pips)) # number of pips
+			bba.ref("t{}_pips".format(tt.index)) # ref to list of pips
+			bba.u32(timing.tile_type_to_tile_index[tt.type] if tt.type in timing.tile_type_to_tile_index else -1) # tile cell timing data index
 		print("Exporting tile and site instances...")
 		for ti in tile_insts:
 			# Mapping from tile wire to node index
@@ -272,6 +427,45 @@ def main():
 			bba.u32(node_wire_count[i]) # number of tile wires in node
 			bba.u32(node_intent[i]) # intent code constid of node
 			bba.ref("n{}_tw".format(i)) # reference to list of tile wires in node, created earlier
+		# Per-node pip index: the pips of all tile wires in each node, in the same order as nextpnr walks them
+		if args.node_pip_index:
+			print("Exporting node pip index...")
+			for j, direction in enumerate(("dh", "uh")):
+				offset = 0
+				bba.label("node_pips_{}_offset".format(direction))
+				for tws in node_tile_wires:
+					bba.u32(offset) # index of first pip of node
+					for tileidx, widx in tws:
+						w = tile_types[tile_insts[tileidx].tile_type].wires[widx]
+						offset += len(w.pips_dh if j == 0 else w.pips_uh)
+				# Offsets are uint32 in nextpnr
+				assert offset < 2**32, "node pip index has too many {} pips ({})".format(direction, offset)
+				bba.u32(offset) # total number of pips
+				bba.label("node_pips_{}".format(direction))
+				for tws in node_tile_wires:
+					for tileidx, widx in tws:
+						w = tile_types[tile_insts[tileidx].tile_type].wires[widx]
+						for pi in (w.pips_dh if j == 0 else w.pips_uh):
+							bba.u32(tileidx) # tile index
+							bba.u32(pi) # pip index in tile
+			bba.label("node_pip_index")
+			bba.u32(len(node_tile_wires)) # number of nodes in index
+			bba.ref("node_pips_dh_offset") # ref to downhill pip offsets
+			bba.ref("node_pips_uh_offset") # ref to uphill pip offsets
+			bba.ref("node_pips_dh") # ref to downhill pip list
+			bba.ref("node_pips_uh") # ref to uphill pip list
+		else:
+			# Empty index, nextpnr falls back to walking the tile wires of each node
+			bba.label("node_pip_index")
+			for i in range(5):
+				bba.u32(0) # no nodes in index
+		# Interconnect locations of nodes, and of tile wires that differ between instances of a tile type
+		bba.label("int_loc_overrides")
+		for tileidx, index, int_x, int_y in int_loc_overrides:
+			bba.u32(tileidx) # tile index, or -1 for a node
+			bba.u32(index) # wire index in tile, or node index
+			bba.u16(int_x) # interconnect tile X
+			bba.u16(int_y) # interconnect tile Y
 		# Wire timing classes
 		bba.label("wire_timing_classes")
 		for wc, i in sorted(timing.wire_classes.items(), key=lambda e: e[1]):
@@ -336,7 +530,7 @@ def main():
 		bba.label("chip_info")
 		bba.str(d.name) # device name char*
 		bba.str("prjxray") # generator name char*
-		bba.u32(1) # version
+		bba.u32(4) # version
 		bba.u32(d.width) # tile grid width
 		bba.u32(d.height) # tile grid height
 		bba.u32(len(tile_insts)) # number of tiles
@@ -348,6 +542,9 @@ def main():
 		bba.ref("extra_constids") # reference to list of constid strings (extra to baked-in ones)
 		bba.u32(1) # only one speed grade currently
 		bba.ref("timing") # timing data
+		bba.ref("node_pip_index") # per-node pip index, possibly empty
+		bba.u32(len(int_loc_overrides)) # number of per-instance interconnect locations
+		bba.ref("int_loc_overrides") # ref to per-instance interconnect locations
 		bba.pop()
 if __name__ == '__main__':
 	main()
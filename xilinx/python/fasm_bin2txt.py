@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""
+Convert a binary FASM file, as written by nextpnr-xilinx --fasm-bin, to text FASM.
+
+See xilinx/fasm_bin.h for a description of the format.
+
+Usage: fasm_bin2txt.py input.fasmb [output.fasm]
+"""
+import mmap
+import struct
+import sys
+
+MAGIC = 0x4253464e
+VERSION = 1
+BLANK = 0xFFFFFFFF
+
+
+def convert(data, out):
+    # Every field is a little-endian uint32 whatever host wrote the file, hence "<" throughout
+    magic, version, num_strings, string_data_size, num_records, num_value_words = struct.unpack_from("<6I", data, 0)
+    if magic != MAGIC:
+        raise ValueError("not a binary FASM file")
+    if version != VERSION:
+        raise ValueError("unsupported binary FASM version {}".format(version))
+    pos = 6 * 4
+    string_offsets = struct.unpack_from("<{}I".format(num_strings), data, pos)
+    pos += 4 * num_strings
+    string_base = pos
+    strings = []
+    for offset in string_offsets:
+        start = string_base + offset
+        end = data.find(b"\0", start)
+        strings.append(data[start:end].decode())
+    pos += string_data_size
+    records_base = pos
+    values_base = records_base + 16 * num_records
+    for i in range(num_records):
+        tile, feature, width, value_index = struct.unpack_from("<4I", data, records_base + 16 * i)
+        if tile == BLANK:
+            out.write("\n")
+            continue
+        name = strings[tile]
+        if strings[feature] != "":
+            name += "." + strings[feature]
+        if width == 0:
+            out.write(name + "\n")
+            continue
+        words = struct.unpack_from("<{}I".format((width + 31) // 32), data, values_base + 4 * value_index)
+        bits = "".join("1" if (words[b // 32] >> (b % 32)) & 1 else "0" for b in reversed(range(width)))
+        out.write("{} = {}'b{}\n".format(name, width, bits))
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+    with open(sys.argv[1], "rb") as f:
+        data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        if len(sys.argv) == 3:
+            with open(sys.argv[2], "w") as out:
+                convert(data, out)
+        else:
+            convert(data, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
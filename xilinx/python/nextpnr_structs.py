@@ -28,6 +28,7 @@ class NextpnrWire:
 		self.pips_uh = []
 		self.pips_dh = []
 		self.belpins = []
+		self.int_offset = None # (dx, dy) to the interconnect tile serving a bel pin wire, or "per_inst"
 
 class NextpnrPip:
 	def __init__(self, index, from_wire, to_wire, timing_class, pip_type):